@@ -0,0 +1,210 @@
+//
+//  cache.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "cache.h"
+
+namespace http {
+    // Non-Member Functions
+
+    // Return the shards a store with policy gets; no more than either budget, so that each shard's share is whole
+    size_t _shard_count(const struct cache::policy& policy, const size_t shards) {
+        size_t result = shards;
+
+        if (policy.max_bytes)
+            result = std::min(result, policy.max_bytes);
+
+        if (policy.max_entries)
+            result = std::min(result, policy.max_entries);
+
+        return result;
+    }
+
+    // Constructors
+
+    cache::cache(const size_t shards) {
+        this->_shards = std::max(shards, (size_t) 1);
+    }
+
+    cache::store::store(const struct policy policy, const size_t shards): shards(_shard_count(policy, shards)) {
+        this->policy = policy;
+    }
+
+    // Member Functions
+
+    void cache::clear() {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+
+        for (const std::shared_ptr<store>& store: this->_stores)
+            for (shard& shard: store->shards) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+
+                shard.index.clear();
+                shard.entries.clear();
+                shard.bytes = 0;
+            }
+    }
+
+    std::shared_ptr<const std::string> cache::store::find(const std::string& key) {
+        shard&                      shard = this->shards[xxhash64(key) % this->shards.size()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(key);
+
+        if (it == shard.index.end()) {
+            this->misses.fetch_add(1);
+
+            return nullptr;
+        }
+
+        std::list<entry>::iterator entry = it->second;
+
+        // Expire lazily
+        if (entry->expires <= std::chrono::steady_clock::now()) {
+            shard.bytes -= entry->message->length();
+            shard.index.erase(it);
+            shard.entries.erase(entry);
+
+            this->misses.fetch_add(1);
+
+            return nullptr;
+        }
+
+        shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+
+        this->hits.fetch_add(1);
+
+        fixdate          current = date();
+        std::string_view now = current;
+
+        if (entry->date_offset == std::string::npos || std::string_view(* entry->message).substr(entry->date_offset, now.length()) == now)
+            return entry->message;
+
+        // Published messages are immutable; splice into a copy
+        std::shared_ptr<std::string> message = std::make_shared<std::string>(* entry->message);
+
+        message->replace(entry->date_offset, now.length(), now);
+
+        entry->message = message;
+
+        return entry->message;
+    }
+
+    void cache::store::insert(std::string key, const std::shared_ptr<const std::string> message) {
+        // Split budgets evenly among shards, rounding down so that together they stay within them
+        size_t max_bytes = this->policy.max_bytes / this->shards.size(),
+               max_entries = this->policy.max_entries / this->shards.size();
+
+        if (max_bytes && message->length() > max_bytes)
+            return;
+
+        shard&                      shard = this->shards[xxhash64(key) % this->shards.size()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(key);
+
+        // Replace a concurrently inserted or expired response
+        if (it != shard.index.end()) {
+            shard.bytes -= it->second->message->length();
+            shard.entries.erase(it->second);
+            shard.index.erase(it);
+        }
+
+        size_t date_offset = message->find("\r\nDate: ");
+
+        if (date_offset != std::string::npos && date_offset < message->find("\r\n\r\n"))
+            date_offset += std::string_view("\r\nDate: ").length();
+        else
+            date_offset = std::string::npos;
+
+        shard.entries.push_front({ date_offset, std::chrono::steady_clock::now() + this->policy.ttl, std::move(key), message });
+        shard.index[shard.entries.front().key] = shard.entries.begin();
+        shard.bytes += message->length();
+
+        while ((max_entries && shard.entries.size() > max_entries) || (max_bytes && shard.bytes > max_bytes)) {
+            shard.bytes -= shard.entries.back().message->length();
+            shard.index.erase(shard.entries.back().key);
+            shard.entries.pop_back();
+        }
+    }
+
+    std::string cache::_key(const request& request, const struct policy& policy) {
+        std::string result = toupperstr(request.method());
+
+        result += ' ';
+
+        // Normalize the path; collapse repeated and trailing slashes
+        for (char c: request.url())
+            if (c != '/' || result.back() != '/')
+                result += c;
+
+        if (result.length() > 1 && result.back() == '/' && result[result.length() - 2] != ' ')
+            result.pop_back();
+
+        // Parameters are ordered by name; names and values are length-prefixed, so that no two requests' keys collide
+        char delimiter = '?';
+
+        for (const auto& [name, param]: request.params()) {
+            result += delimiter + _length_prefixed(name) + '=' + _length_prefixed(param.str());
+
+            delimiter = '&';
+        }
+
+        for (const std::string& name: policy.vary)
+            result += '\n' + _length_prefixed(request.headers()[name].value());
+
+        return result;
+    }
+
+    std::string cache::_length_prefixed(const std::string_view value) {
+        return std::to_string(value.length()) + ':' + std::string(value);
+    }
+
+    router::handler cache::route(const policy policy, const router::handler handler) {
+        std::shared_ptr<store> store = std::make_shared<struct store>(policy, this->_shards);
+
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+
+            this->_stores.push_back(store);
+        }
+
+        return [store, handler](const request& request, const router::params& params) {
+            std::string                        key = _key(request, store->policy);
+            std::shared_ptr<const std::string> result = store->find(key);
+
+            if (result)
+                return result;
+
+            result = handler(request, params);
+
+            // Cache successful responses, unless told not to
+            if (std::string_view(* result).substr(0, status_line(OK).length()) == status_line(OK) && find_header(* result, field::CACHE_CONTROL).find("no-store") == std::string_view::npos)
+                store->insert(std::move(key), result);
+
+            return result;
+        };
+    }
+
+    struct cache::stats cache::stats() const {
+        struct stats                result;
+        std::lock_guard<std::mutex> lock(this->_mutex);
+
+        for (const std::shared_ptr<store>& store: this->_stores) {
+            result.hits += store->hits.load();
+            result.misses += store->misses.load();
+
+            for (shard& shard: store->shards) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+
+                result.bytes += shard.bytes;
+                result.entries += shard.entries.size();
+            }
+        }
+
+        return result;
+    }
+}
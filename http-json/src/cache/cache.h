@@ -0,0 +1,129 @@
+//
+//  cache.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef cache_h
+#define cache_h
+
+#include "router.h"
+#include <chrono>
+#include <list>
+#include <unordered_map>
+
+namespace http {
+    /**
+     * Lock-striped LRU cache of successful responses; routes opt in by wrapping their handlers
+     */
+    class cache {
+    public:
+        // Typedef
+
+        struct policy {
+            // Member Fields
+
+            // Zero is unlimited; split among a route's shards, which are no more than either budget
+            size_t                    max_bytes = 0;
+            size_t                    max_entries = 0;
+
+            std::chrono::milliseconds ttl = std::chrono::milliseconds(1000);
+
+            // Request headers that select a representation; handlers still declare them in Vary
+            std::vector<std::string>  vary;
+        };
+
+        struct stats {
+            // Member Fields
+
+            size_t bytes = 0;
+            size_t entries = 0;
+            size_t hits = 0;
+            size_t misses = 0;
+        };
+
+        // Constructors
+
+        cache(const size_t shards = 16);
+
+        cache(const cache& other) = delete;
+
+        // Member Functions
+
+        /**
+         * Drop every cached response
+         */
+        void            clear();
+
+        /**
+         * Return a handler that serves handler's 200 responses from the cache for policy.ttl; expired responses are
+         * dropped when next looked up
+         */
+        router::handler route(const policy policy, const router::handler handler);
+
+        /**
+         * Return totals across routes
+         */
+        struct stats    stats() const;
+    private:
+        // Typedef
+
+        struct entry {
+            // Member Fields
+
+            // Offset of the Date value, or npos
+            size_t                                date_offset;
+            std::chrono::steady_clock::time_point expires;
+            std::string                           key;
+            std::shared_ptr<const std::string>    message;
+        };
+
+        struct shard {
+            // Member Fields
+
+            size_t                                                                   bytes = 0;
+
+            // Most recently used first; keys view entries' own
+            std::list<entry>                                                         entries;
+            std::unordered_map<std::string_view, std::list<entry>::iterator>         index;
+            std::mutex                                                               mutex;
+        };
+
+        struct store {
+            // Constructors
+
+            store(const struct policy policy, const size_t shards);
+
+            // Member Fields
+
+            std::atomic<size_t> hits = 0;
+            std::atomic<size_t> misses = 0;
+            struct policy       policy;
+            std::vector<shard>  shards;
+
+            // Member Functions
+
+            std::shared_ptr<const std::string> find(const std::string& key);
+
+            void                               insert(std::string key, const std::shared_ptr<const std::string> message);
+        };
+
+        // Member Fields
+
+        mutable std::mutex                  _mutex;
+        size_t                              _shards;
+        std::vector<std::shared_ptr<store>> _stores;
+
+        // Member Functions
+
+        static std::string _key(const request& request, const struct policy& policy);
+
+        /**
+         * Return value preceded by its length, so that it can't run into what follows it
+         */
+        static std::string _length_prefixed(const std::string_view value);
+    };
+}
+
+#endif /* cache_h */
@@ -0,0 +1,422 @@
+//
+//  client.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "client.h"
+
+namespace http {
+    // Non-Member Functions
+
+    // Return the tokens of a Connection header, in lowercase
+    std::set<std::string> _connection_options(const std::string_view value) {
+        std::string lower = tolowerstr(std::string(value));
+
+        return header_view(lower).list();
+    }
+
+    // Return true if method may be repeated without changing its effect
+    bool _idempotent(const method_code method) {
+        return method != CONNECT && method != PATCH && method != POST && method != UNKNOWN_METHOD;
+    }
+
+    size_t response_length(const std::string_view buffer, const bool head, const bool eof, bool& keep_alive) {
+        response_framer framer;
+
+        return framer.length(buffer, head, eof, keep_alive);
+    }
+
+    // Constructors
+
+    client::client(): client(options()) { }
+
+    client::client(const struct options options) {
+        this->_options = options;
+    }
+
+    client::response::response(std::string message, const bool head) {
+        std::shared_ptr<std::string> text = std::make_shared<std::string>(std::move(message));
+        size_t                       start = 0;
+
+        // Advance past the next line, excluding its terminator
+        auto getline = [&text, &start](std::string_view& line) {
+            if (start == text->length())
+                return false;
+
+            size_t end = text->find('\n', start);
+
+            if (end == std::string::npos)
+                end = text->length();
+
+            line = std::string_view(* text).substr(start, end - start);
+
+            if (line.length() && line.back() == '\r')
+                line.remove_suffix(1);
+
+            start = std::min(end + 1, text->length());
+
+            return true;
+        };
+
+        std::string_view line;
+
+        // HTTP/1.x SP status-code SP [ reason-phrase ]
+        if (!getline(line) || !line.starts_with("HTTP/1.") || line.length() < 12 || line[8] != ' ')
+            throw mysocket::error(EPROTO);
+
+        std::from_chars_result status = std::from_chars(line.data() + 9, line.data() + 12, this->_status);
+
+        if (status.ec != std::errc() || status.ptr != line.data() + 12 || this->_status < 100)
+            throw mysocket::error(EPROTO);
+
+        this->_status_text = trim_view(line.substr(12));
+
+        while (getline(line)) {
+            size_t colon = line.find(':');
+
+            if (colon == std::string_view::npos)
+                break;
+
+            this->_headers.insert(line.substr(0, colon), trim_view(line.substr(colon + 1)));
+        }
+
+        // Bodiless, whatever the headers say
+        if (!(head || this->_status < 200 || this->_status == NO_CONTENT || this->_status == NOT_MODIFIED)) {
+            if (is_chunked(this->_headers[field::TRANSFER_ENCODING])) {
+                // Decoded data is never longer than its encoding; decode in place
+                char*         data = text->data() + start;
+                size_t        length = 0;
+                chunk_decoder decoder;
+
+                decoder.decode(std::string_view(* text).substr(start), [data, &length](const std::string_view value) {
+                    memmove(data + length, value.data(), value.length());
+
+                    length += value.length();
+                });
+
+                this->_body = std::string_view(data, length);
+            } else if (this->_headers.contains(field::CONTENT_LENGTH))
+                this->_body = std::string_view(* text).substr(start, std::max(this->_headers[field::CONTENT_LENGTH].int_value(), 0));
+            else
+                // Delimited by the connection closing
+                this->_body = std::string_view(* text).substr(start);
+        }
+
+        this->_message = text;
+
+        content_coding coding = parse_coding(this->_headers[field::CONTENT_ENCODING]);
+
+        if (coding == UNKNOWN_CODING)
+            throw mysocket::error(EPROTO);
+
+        if (coding == IDENTITY || this->_body.empty())
+            return;
+
+        // Bounded as request bodies are, against compression bombs
+        this->_decoded = std::make_shared<const std::string>(decompress(this->_body, coding, max_body_size()));
+        this->_body = * this->_decoded;
+    }
+
+    client::~client() {
+        for (auto& [key, pool]: this->_pools)
+            for (struct idle_connection& idle: pool.idle)
+                try {
+                    idle.connection->close();
+                } catch (mysocket::error& e) { }
+    }
+
+    // Member Functions
+
+    mysocket::tcp_client* client::_acquire(const std::string& host, const int port, bool& reused) {
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + this->_options.connect_timeout;
+        std::unique_lock<std::mutex>          lock(this->_mutex);
+        pool&                                 pool = this->_pools[host + ":" + std::to_string(port)];
+
+        while (true) {
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+            // Most recently used first; the least are likeliest to have expired
+            while (pool.idle.size()) {
+                struct idle_connection idle = pool.idle.back();
+
+                pool.idle.pop_back();
+
+                // Closed by the server meanwhile, or about to be
+                if (now - idle.since < this->_options.idle_timeout && !idle.connection->readable()) {
+                    reused = true;
+
+                    return idle.connection;
+                }
+
+                try {
+                    idle.connection->close();
+                } catch (mysocket::error& e) { }
+
+                pool.open--;
+            }
+
+            if (pool.open < this->_options.max_per_host)
+                break;
+
+            if (pool.available.wait_until(lock, deadline) == std::cv_status::timeout)
+                throw mysocket::error(ETIMEDOUT);
+        }
+
+        pool.open++;
+
+        lock.unlock();
+
+        reused = false;
+
+        try {
+            return new mysocket::tcp_client(host, port, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()));
+        } catch (mysocket::error& e) {
+            lock.lock();
+
+            pool.open--;
+            pool.available.notify_one();
+
+            throw e;
+        }
+    }
+
+    std::string_view client::response::body() const {
+        return this->_body;
+    }
+
+    std::vector<client::response> client::_exchange(mysocket::tcp_client* connection, const std::string& authority, const std::vector<message>& messages, bool& received, bool& reusable) const {
+        std::string requests;
+
+        for (const message& message: messages) {
+            requests += strmethod(message.method) + " " + message.target + " " + http_version() + "\r\n";
+            requests += "Host: " + authority + "\r\n";
+
+            for (const auto& [key, value]: message.headers)
+                requests += key + ": " + value.str() + "\r\n";
+
+            if (message.body.length() || (message.method != GET && message.method != HEAD))
+                requests += "Content-Length: " + std::to_string(message.body.length()) + "\r\n";
+
+            requests += "\r\n" + message.body;
+        }
+
+        connection->send(requests, this->_options.write_timeout);
+
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + this->_options.read_timeout;
+        std::string                           buffer;
+        bool                                  eof = false,
+                                              keep_alive = true;
+        response_framer                       framer;
+        std::vector<response>                 result;
+
+        while (result.size() < messages.size()) {
+            bool   head = messages[result.size()].method == HEAD;
+            size_t length = framer.length(buffer, head, eof, keep_alive);
+
+            if (length) {
+                response response(buffer.substr(0, length), head);
+
+                buffer.erase(0, length);
+
+                // Informational; the final response follows
+                if (response.status() < 200)
+                    continue;
+
+                result.push_back(response);
+
+                // Later requests go unanswered
+                if (!keep_alive && result.size() < messages.size())
+                    throw mysocket::error(ECONNRESET);
+
+                continue;
+            }
+
+            if (eof)
+                throw mysocket::error(ECONNRESET);
+
+            if (buffer.length() >= this->_options.max_response_size)
+                throw mysocket::error(EMSGSIZE);
+
+            std::chrono::milliseconds remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+
+            if (remaining.count() <= 0)
+                throw mysocket::error(ETIMEDOUT);
+
+            if (connection->recv(buffer, remaining))
+                received = true;
+            else
+                eof = true;
+        }
+
+        // Anything more is unsolicited
+        reusable = keep_alive && !eof && buffer.empty();
+
+        return result;
+    }
+
+    const header_view::map& client::response::headers() const {
+        return this->_headers;
+    }
+
+    json::object* client::response::json() const {
+        return json::parse(std::string(this->_body));
+    }
+
+    size_t response_framer::length(const std::string_view buffer, const bool head, const bool eof, bool& keep_alive) {
+        if (!this->_head) {
+            if (!this->_find_head(buffer))
+                return 0;
+
+            std::string_view line = buffer.substr(0, buffer.find('\n'));
+
+            if (!line.starts_with("HTTP/1.") || line.length() < 12)
+                throw mysocket::error(EPROTO);
+
+            std::from_chars_result result = std::from_chars(line.data() + 9, line.data() + 12, this->_status);
+
+            // Three digits, as response parses them
+            if (result.ec != std::errc() || result.ptr != line.data() + 12 || this->_status < 100)
+                throw mysocket::error(EPROTO);
+
+            // Persistent by default from HTTP/1.1 on
+            bool keep_alive_default = line[7] != '0';
+
+            this->_keep_alive = keep_alive_default;
+
+            for (size_t start = line.length() + 1; start < this->_head; ) {
+                size_t           eol = buffer.find('\n', start);
+                std::string_view header = buffer.substr(start, eol - start);
+                size_t           colon = header.find(':');
+
+                if (colon != std::string_view::npos) {
+                    field            name = parse_field(trim_view(header.substr(0, colon)));
+                    std::string_view value = trim_view(header.substr(colon + 1));
+
+                    if (name == field::CONTENT_LENGTH) {
+                        int content_length = header_view(value).int_value();
+
+                        if (content_length < 0 || (this->_content_length != -1 && content_length != this->_content_length))
+                            throw mysocket::error(EPROTO);
+
+                        this->_content_length = content_length;
+                    } else if (name == field::TRANSFER_ENCODING)
+                        this->_chunked = is_chunked(value);
+                    else if (name == field::CONNECTION) {
+                        std::set<std::string> options = _connection_options(value);
+
+                        this->_keep_alive = keep_alive_default ? !options.contains("close") : options.contains("keep-alive");
+                    }
+                }
+
+                start = eol + 1;
+            }
+        }
+
+        size_t length = this->_head;
+
+        keep_alive = this->_keep_alive;
+
+        // Bodiless, whatever the headers say
+        if (!(head || this->_status < 200 || this->_status == NO_CONTENT || this->_status == NOT_MODIFIED)) {
+            // Transfer-Encoding overrides Content-Length
+            if (this->_chunked) {
+                size_t body;
+
+                try {
+                    body = this->_chunked_length(buffer);
+                } catch (http::error& e) {
+                    throw mysocket::error(EPROTO);
+                }
+
+                if (!body)
+                    return 0;
+
+                length += body;
+            } else if (this->_content_length >= 0) {
+                length += this->_content_length;
+
+                if (length > buffer.length())
+                    return 0;
+            } else {
+                // Delimited by the connection closing
+                keep_alive = false;
+
+                if (!eof)
+                    return 0;
+
+                length = buffer.length();
+            }
+        }
+
+        // The next call frames the next response
+        * this = response_framer();
+
+        return length;
+    }
+
+    void client::_release(const std::string& host, const int port, mysocket::tcp_client* connection, const bool reusable) {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        pool&                       pool = this->_pools[host + ":" + std::to_string(port)];
+
+        if (reusable && pool.idle.size() < this->_options.max_idle)
+            pool.idle.push_back({ connection, std::chrono::steady_clock::now() });
+        else {
+            try {
+                connection->close();
+            } catch (mysocket::error& e) { }
+
+            pool.open--;
+        }
+
+        pool.available.notify_one();
+    }
+
+    client::response client::send(const std::string host, const int port, const message& message) {
+        return std::move(this->send(host, port, std::vector<struct message> { message })[0]);
+    }
+
+    std::vector<client::response> client::send(const std::string host, const int port, const std::vector<message>& messages) {
+        if (messages.empty())
+            return { };
+
+        std::string authority = host + ":" + std::to_string(port);
+        bool        idempotent = std::all_of(messages.begin(), messages.end(), [](const message& message) {
+            return _idempotent(message.method);
+        });
+
+        for (size_t attempt = 0; ; attempt++) {
+            bool                  reused;
+            mysocket::tcp_client* connection = this->_acquire(host, port, reused);
+            bool                  received = false,
+                                  reusable = false;
+
+            try {
+                std::vector<response> result = this->_exchange(connection, authority, messages, received, reusable);
+
+                this->_release(host, port, connection, reusable);
+
+                return result;
+            } catch (mysocket::error& e) {
+                this->_release(host, port, connection, false);
+
+                // Closed as it was reused, before answering; not timed out
+                if (!(reused && !received && idempotent && !attempt && e.errnum() != ETIMEDOUT))
+                    throw e;
+            } catch (...) {
+                this->_release(host, port, connection, false);
+
+                throw;
+            }
+        }
+    }
+
+    int client::response::status() const {
+        return this->_status;
+    }
+
+    std::string_view client::response::status_text() const {
+        return this->_status_text;
+    }
+}
@@ -0,0 +1,205 @@
+//
+//  client.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef client_h
+#define client_h
+
+#include "http.h"
+#include "json.h"
+#include "socket.h"
+#include <chrono>
+#include <condition_variable>
+#include <unordered_map>
+#include <vector>
+
+namespace http {
+    /**
+     * HTTP/1.1 client for calls to other services, keeping connections alive per host so that calls don't each pay
+     * for a handshake and an ephemeral port. Thread-safe; a call borrows an idle connection to its host, or opens one,
+     * and returns it to the pool if the server keeps it open. Network errors, deadlines, and malformed responses throw
+     * mysocket::error
+     */
+    class client {
+    public:
+        // Typedef
+
+        struct options {
+            // Member Fields
+
+            std::chrono::milliseconds connect_timeout = std::chrono::milliseconds(1000);
+
+            // Idle connections are closed after this long; shorter than servers' keep-alive timeout, so that they
+            // aren't reused as they close
+            std::chrono::milliseconds idle_timeout = std::chrono::milliseconds(4000);
+
+            // Idle connections kept per host; others are closed as calls finish
+            size_t                    max_idle = 8;
+
+            // Connections per host, idle or in use; calls beyond it wait up to connect_timeout for one
+            size_t                    max_per_host = 64;
+
+            // Largest response, with its headers, accepted
+            size_t                    max_response_size = 16 << 20;
+
+            // Deadline for every response to a call, from when its requests are sent
+            std::chrono::milliseconds read_timeout = std::chrono::milliseconds(5000);
+
+            // Deadline for sending a call's requests
+            std::chrono::milliseconds write_timeout = std::chrono::milliseconds(5000);
+        };
+
+        /**
+         * Request to send; Host and Content-Length are added
+         */
+        struct message {
+            // Member Fields
+
+            std::string body;
+            header::map headers;
+            method_code method = GET;
+            std::string target = "/";
+        };
+
+        class response {
+        public:
+            // Constructors
+
+            /**
+             * Parse message, a complete response; its body is empty if it answers a HEAD request
+             */
+            response(std::string message, const bool head = false);
+
+            // Member Functions
+
+            std::string_view        body() const;
+
+            const header_view::map& headers() const;
+
+            /**
+             * Parse the body as JSON; the caller deletes the result. Throw json::error if it's malformed
+             */
+            json::object*           json() const;
+
+            int                     status() const;
+
+            std::string_view        status_text() const;
+        private:
+            // Member Fields
+
+            std::string_view                   _body;
+
+            // Body after content decoding, if it was encoded
+            std::shared_ptr<const std::string> _decoded;
+            header_view::map                   _headers;
+
+            // Views point into it; shared by copies
+            std::shared_ptr<const std::string> _message;
+            int                                _status = 0;
+            std::string_view                   _status_text;
+        };
+
+        // Constructors
+
+        client();
+
+        client(const struct options options);
+
+        client(const client& other) = delete;
+
+        /**
+         * Close idle connections; calls must have returned
+         */
+        ~client();
+
+        // Member Functions
+
+        /**
+         * Send message to host, an IPv4 address, and return the response
+         */
+        response              send(const std::string host, const int port, const message& message);
+
+        /**
+         * Pipeline messages to host on one connection, and return their responses in order. A connection that was
+         * idle, and that the server closes before responding, is replaced once if every message is idempotent
+         */
+        std::vector<response> send(const std::string host, const int port, const std::vector<message>& messages);
+    private:
+        // Typedef
+
+        struct idle_connection {
+            // Member Fields
+
+            mysocket::tcp_client*                 connection;
+            std::chrono::steady_clock::time_point since;
+        };
+
+        struct pool {
+            // Member Fields
+
+            // Signaled when a connection is returned or closed
+            std::condition_variable      available;
+
+            // Least recently used first
+            std::vector<idle_connection> idle;
+            size_t                       open = 0;
+        };
+
+        // Member Fields
+
+        std::mutex                            _mutex;
+        struct options                        _options;
+        std::unordered_map<std::string, pool> _pools;
+
+        // Member Functions
+
+        /**
+         * Borrow a connection to host; reused is true if it was idle
+         */
+        mysocket::tcp_client* _acquire(const std::string& host, const int port, bool& reused);
+
+        /**
+         * Send messages over connection and read their responses; received is true once any byte arrives, and
+         * reusable is true if the connection may carry more
+         */
+        std::vector<response> _exchange(mysocket::tcp_client* connection, const std::string& authority, const std::vector<message>& messages, bool& received, bool& reusable) const;
+
+        /**
+         * Return connection to host's pool if reusable and there's room, otherwise close it
+         */
+        void                  _release(const std::string& host, const int port, mysocket::tcp_client* connection, const bool reusable);
+    };
+
+    /**
+     * Frames responses as they arrive in pieces, as message_framer does requests
+     */
+    class response_framer: message_framer {
+    public:
+        // Member Functions
+
+        /**
+         * Return the length of the first complete response in buffer, otherwise 0; head is true if it answers a HEAD
+         * request, and eof is true if no more will arrive. keep_alive is false if the connection closes after it.
+         * Throw mysocket::error if the response is malformed, or has conflicting Content-Length values. Until a
+         * length is returned, buffer must begin with the bytes earlier calls were given
+         */
+        size_t length(const std::string_view buffer, const bool head, const bool eof, bool& keep_alive);
+    private:
+        // Member Fields
+
+        bool   _keep_alive = true;
+        int    _status = 0;
+    };
+
+    // Non-Member Functions
+
+    /**
+     * As response_framer::length, for a buffer that holds the response so far
+     */
+    size_t response_length(const std::string_view buffer, const bool head, const bool eof, bool& keep_alive);
+}
+
+#endif /* client_h */
@@ -0,0 +1,364 @@
+//
+//  file_server.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "file_server.h"
+
+namespace http {
+    // Non-Member Functions
+
+    std::string_view _content_type(const std::string_view path) {
+        static const std::unordered_map<std::string_view, std::string_view> types = {
+            { "css", "text/css; charset=utf-8" },
+            { "gif", "image/gif" },
+            { "htm", "text/html; charset=utf-8" },
+            { "html", "text/html; charset=utf-8" },
+            { "ico", "image/x-icon" },
+            { "jpeg", "image/jpeg" },
+            { "jpg", "image/jpeg" },
+            { "js", "text/javascript; charset=utf-8" },
+            { "json", "application/json" },
+            { "pdf", "application/pdf" },
+            { "png", "image/png" },
+            { "svg", "image/svg+xml" },
+            { "txt", "text/plain; charset=utf-8" },
+            { "wasm", "application/wasm" },
+            { "webp", "image/webp" },
+            { "xml", "application/xml" }
+        };
+
+        size_t dot = path.rfind('.');
+
+        if (dot != std::string_view::npos && path.find('/', dot) == std::string_view::npos) {
+            auto it = types.find(tolowerstr(std::string(path.substr(dot + 1))));
+
+            if (it != types.end())
+                return it->second;
+        }
+
+        return "application/octet-stream";
+    }
+
+    // Return path with percent-encoded octets decoded, or an empty string if path escapes its root
+    std::string _normalize(const std::string_view path) {
+        std::string result;
+
+        for (size_t i = 0; i < path.length(); i++) {
+            if (path[i] == '%' && i + 2 < path.length() && isxdigit(path[i + 1]) && isxdigit(path[i + 2])) {
+                result += (char) std::stoi(std::string(path.substr(i + 1, 2)), nullptr, 16);
+
+                i += 2;
+            } else
+                result += path[i];
+        }
+
+        if (result.find('\0') != std::string::npos)
+            return "";
+
+        // Reject parent segments
+        for (size_t start = 0; start <= result.length(); ) {
+            size_t end = std::min(result.find('/', start), result.length());
+
+            if (std::string_view(result).substr(start, end - start) == "..")
+                return "";
+
+            start = end + 1;
+        }
+
+        if (result.empty() || result.back() == '/')
+            result += "index.html";
+
+        return result;
+    }
+
+    // Parse a single byte range against size; return false if it's unsatisfiable
+    bool _parse_range(std::string_view value, const off_t size, off_t& offset, size_t& length) {
+        value = trim_view(value.substr(std::string_view("bytes=").length()));
+
+        size_t dash = value.find('-');
+
+        if (dash == std::string_view::npos)
+            return false;
+
+        std::string_view first = trim_view(value.substr(0, dash)),
+                         last = trim_view(value.substr(dash + 1));
+        off_t            start = 0,
+                         end = size - 1;
+
+        auto parse = [](const std::string_view text, off_t& value) {
+            std::from_chars_result result = std::from_chars(text.data(), text.data() + text.length(), value);
+
+            return result.ec == std::errc() && result.ptr == text.data() + text.length();
+        };
+
+        if (first.empty()) {
+            off_t suffix;
+
+            // Last suffix bytes
+            if (!parse(last, suffix) || suffix <= 0)
+                return false;
+
+            start = std::max(size - suffix, (off_t) 0);
+        } else {
+            if (!parse(first, start) || (last.length() && !parse(last, end)))
+                return false;
+
+            end = std::min(end, size - 1);
+        }
+
+        if (start >= size || start > end)
+            return false;
+
+        offset = start;
+        length = end - start + 1;
+
+        return true;
+    }
+
+    // Constructors
+
+    file_server::file::file(const int file_descriptor, const struct stat info): file_descriptor(file_descriptor), info(info), last_modified(date(info.st_mtime)) { }
+
+    file_server::file::~file() {
+        ::close(this->file_descriptor);
+    }
+
+    file_server::file_server(const std::string root) {
+        this->_root = root;
+
+        while (this->_root.length() > 1 && this->_root.back() == '/')
+            this->_root.pop_back();
+
+#ifdef __linux__
+        this->_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+        if (this->_inotify != -1)
+            this->_watcher = std::thread([this]() {
+                this->_watch();
+            });
+#endif
+    }
+
+    file_server::~file_server() {
+#ifdef __linux__
+        this->_alive.store(false);
+
+        if (this->_watcher.joinable())
+            this->_watcher.join();
+
+        if (this->_inotify != -1)
+            ::close(this->_inotify);
+#endif
+    }
+
+    // Member Functions
+
+    void file_server::clear() {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+
+        this->_files.clear();
+    }
+
+    std::shared_ptr<const file_server::file> file_server::_open(const std::string& path) {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+
+        auto it = this->_files.find(path);
+
+        if (it != this->_files.end()) {
+#ifdef __linux__
+            return it->second.file;
+#else
+            // Changes aren't watched; revalidate at most once per second
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+            if (now - it->second.checked < std::chrono::seconds(1))
+                return it->second.file;
+
+            struct stat info;
+
+            if (stat(path.c_str(), &info) == 0 && info.st_ino == it->second.file->info.st_ino && info.st_size == it->second.file->info.st_size && info.st_mtime == it->second.file->info.st_mtime) {
+                it->second.checked = now;
+
+                return it->second.file;
+            }
+
+            this->_files.erase(it);
+#endif
+        }
+
+        int file_descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (file_descriptor == -1)
+            return nullptr;
+
+        struct stat info;
+
+        if (fstat(file_descriptor, &info) == -1 || !S_ISREG(info.st_mode)) {
+            ::close(file_descriptor);
+
+            return nullptr;
+        }
+
+        std::shared_ptr<const file> result = std::make_shared<const file>(file_descriptor, info);
+
+#ifdef __linux__
+        if (this->_inotify != -1) {
+            std::string directory = path.substr(0, path.rfind('/'));
+            int         watch = inotify_add_watch(this->_inotify, directory.c_str(), IN_ATTRIB | IN_CLOSE_WRITE | IN_DELETE | IN_DELETE_SELF | IN_MODIFY | IN_MOVE_SELF | IN_MOVED_FROM | IN_MOVED_TO);
+
+            // Unwatched files are opened per request
+            if (watch == -1)
+                return result;
+
+            this->_watches[watch] = directory;
+        } else
+            return result;
+#endif
+
+        this->_files[path] = { std::chrono::steady_clock::now(), result };
+
+        return result;
+    }
+
+#ifdef __linux__
+    void file_server::_watch() {
+        alignas(struct inotify_event) char buff[4096];
+        struct pollfd                      fds = { this->_inotify, POLLIN, 0 };
+
+        while (this->_alive.load()) {
+            // Wake periodically to observe shut down
+            if (poll(&fds, 1, 1000) <= 0)
+                continue;
+
+            ssize_t len = read(this->_inotify, buff, sizeof(buff));
+
+            if (len <= 0)
+                continue;
+
+            std::lock_guard<std::mutex> lock(this->_mutex);
+
+            for (char* ptr = buff; ptr < buff + len; ) {
+                const struct inotify_event* event = (const struct inotify_event*) ptr;
+
+                ptr += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    this->_files.clear();
+
+                    continue;
+                }
+
+                auto watch = this->_watches.find(event->wd);
+
+                if (watch == this->_watches.end())
+                    continue;
+
+                if (event->len) {
+                    this->_files.erase(watch->second + "/" + event->name);
+
+                    continue;
+                }
+
+                // The directory itself changed; forget everything under it
+                std::string prefix = watch->second + "/";
+
+                for (auto it = this->_files.begin(); it != this->_files.end(); )
+                    if (it->first.starts_with(prefix))
+                        it = this->_files.erase(it);
+                    else
+                        it++;
+
+                if (event->mask & IN_IGNORED)
+                    this->_watches.erase(watch);
+            }
+        }
+    }
+#endif
+
+    file_server::reply file_server::serve(const request& request, const std::string_view path) {
+        thread_local response_builder builder;
+
+        reply       result;
+        std::string relative = _normalize(path);
+
+        builder.clear();
+
+        std::shared_ptr<const file> file = relative.empty() ? nullptr : this->_open(this->_root + "/" + relative);
+
+        if (!file) {
+            builder.status(NOT_FOUND);
+            builder.date();
+            builder.headers({ { "Content-Type", std::string("text/plain; charset=utf-8") } });
+            builder.body(strstatus(NOT_FOUND));
+
+            result.message = std::make_shared<const std::string>(builder.str());
+
+            return result;
+        }
+
+        const header_view& if_modified_since = request.headers()[field::IF_MODIFIED_SINCE];
+        const header_view& range = request.headers()[field::RANGE];
+
+        status_code status = OK;
+        off_t       offset = 0;
+        size_t      length = file->info.st_size;
+        time_t      since = if_modified_since.empty() ? -1 : parse_date(if_modified_since.value());
+
+        // Unchanged since the client's copy; dates in the future are invalid, and ignored
+        if (since != -1 && file->info.st_mtime <= since && since <= time(NULL))
+            status = NOT_MODIFIED;
+        else if (range.value().starts_with("bytes=") && range.value().find(',') == std::string_view::npos) {
+            // Multiple ranges are served in full
+            if (_parse_range(range, file->info.st_size, offset, length))
+                status = PARTIAL_CONTENT;
+            else
+                status = RANGE_NOT_SATISFIABLE;
+        }
+
+        builder.status(status);
+        builder.date();
+        builder.headers({ });
+        builder.header("Accept-Ranges", "bytes");
+        builder.header("Last-Modified", file->last_modified);
+
+        switch (status) {
+            case NOT_MODIFIED:
+                builder.body("", false);
+
+                result.message = std::make_shared<const std::string>(builder.str());
+
+                return result;
+            case RANGE_NOT_SATISFIABLE:
+                builder.header("Content-Range", "bytes */" + std::to_string(file->info.st_size));
+                builder.body("");
+
+                result.message = std::make_shared<const std::string>(builder.str());
+
+                return result;
+            case PARTIAL_CONTENT:
+                builder.header("Content-Range", "bytes " + std::to_string(offset) + "-" + std::to_string(offset + length - 1) + "/" + std::to_string(file->info.st_size));
+
+                break;
+            default:
+                break;
+        }
+
+        builder.header("Content-Type", _content_type(relative));
+        builder.header("Content-Length", std::to_string(length));
+        builder.body("", false);
+
+        result.message = std::make_shared<const std::string>(builder.str());
+
+        // HEAD responses are bodiless
+        if (parse_method(request.method()) != HEAD && length) {
+            result.file = file;
+            result.offset = offset;
+            result.length = length;
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,111 @@
+//
+//  file_server.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef file_server_h
+#define file_server_h
+
+#include "http.h"
+#include <chrono>
+#include <fcntl.h>      // open
+#include <sys/stat.h>   // fstat
+#include <unordered_map>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+namespace http {
+    /**
+     * Serves files under a directory; open descriptors and their metadata are cached until the files change
+     */
+    class file_server {
+    public:
+        // Typedef
+
+        struct file {
+            // Constructors
+
+            file(const int file_descriptor, const struct stat info);
+
+            file(const file& other) = delete;
+
+            ~file();
+
+            // Member Fields
+
+            const int         file_descriptor;
+            const struct stat info;
+            const std::string last_modified;
+        };
+
+        struct reply {
+            // Member Fields
+
+            // Body, if any, sent after message
+            std::shared_ptr<const file_server::file> file;
+            size_t                                   length = 0;
+            off_t                                    offset = 0;
+
+            // Status line and headers, or a complete message if there's no file
+            std::shared_ptr<const std::string>       message;
+        };
+
+        // Constructors
+
+        file_server(const std::string root);
+
+        file_server(const file_server& other) = delete;
+
+        ~file_server();
+
+        // Member Functions
+
+        /**
+         * Forget every cached file; each is reopened when next served. Replies in flight keep theirs open
+         */
+        void  clear();
+
+        /**
+         * Return the response to a GET or HEAD request for path, relative to root; supports single byte ranges
+         */
+        reply serve(const request& request, const std::string_view path);
+    private:
+        // Typedef
+
+        struct entry {
+            // Member Fields
+
+            // Last time info was compared with the file system, where changes aren't watched
+            std::chrono::steady_clock::time_point    checked;
+            std::shared_ptr<const file_server::file> file;
+        };
+
+        // Member Fields
+
+        std::unordered_map<std::string, entry> _files;
+        std::mutex                             _mutex;
+        std::string                            _root;
+#ifdef __linux__
+        std::atomic<bool>                      _alive = true;
+        int                                    _inotify;
+        std::thread                            _watcher;
+
+        // Watched directories by watch descriptor
+        std::unordered_map<int, std::string>   _watches;
+#endif
+
+        // Member Functions
+
+        std::shared_ptr<const file> _open(const std::string& path);
+#ifdef __linux__
+
+        void                        _watch();
+#endif
+    };
+}
+
+#endif /* file_server_h */
@@ -0,0 +1,338 @@
+//
+//  compression.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "compression.h"
+#include "http.h"
+#include <cstring>
+#include <list>
+#include <tuple>
+#include <zlib.h>
+
+namespace http {
+    // Typedef
+
+    // Coding, hash, and length of an uncompressed body
+    using _memo_key = std::tuple<content_coding, uint64_t, size_t>;
+
+    // Non-Member Fields
+
+    std::atomic<int>                   _compression_level = Z_DEFAULT_COMPRESSION;
+    std::atomic<size_t>                _compression_threshold = 1024;
+
+    // Compressed bodies of cacheable messages, most recently used first
+    std::list<std::pair<_memo_key, std::shared_ptr<const std::string>>>                                   _memo;
+    std::map<_memo_key, std::list<std::pair<_memo_key, std::shared_ptr<const std::string>>>::iterator> _memo_index;
+    std::mutex                                                                                            _memo_mutex;
+
+    // Non-Member Functions
+
+    size_t _memo_capacity() {
+        return 256;
+    }
+
+    std::shared_ptr<const std::string> _memoize(const std::string_view body, const content_coding coding) {
+        _memo_key key = { coding, xxhash64(body), body.length() };
+
+        _memo_mutex.lock();
+
+        auto it = _memo_index.find(key);
+
+        if (it != _memo_index.end()) {
+            _memo.splice(_memo.begin(), _memo, it->second);
+
+            std::shared_ptr<const std::string> result = it->second->second;
+
+            _memo_mutex.unlock();
+
+            return result;
+        }
+
+        _memo_mutex.unlock();
+
+        // Compress outside the lock; racing threads store equal values
+        std::shared_ptr<const std::string> result = std::make_shared<const std::string>(compress(body, coding, compression_level()));
+
+        _memo_mutex.lock();
+
+        if (_memo_index.find(key) == _memo_index.end()) {
+            _memo.push_front({ key, result });
+            _memo_index[key] = _memo.begin();
+
+            if (_memo.size() > _memo_capacity()) {
+                _memo_index.erase(_memo.back().first);
+                _memo.pop_back();
+            }
+        }
+
+        _memo_mutex.unlock();
+
+        return result;
+    }
+
+    std::string compress(const std::string_view text, const content_coding coding, const int level) {
+        if (coding != DEFLATE && coding != GZIP)
+            return std::string(text);
+
+        z_stream stream;
+
+        memset(&stream, 0, sizeof(stream));
+
+        // 15-bit window; + 16 for a gzip wrapper instead of zlib's
+        if (deflateInit2(&stream, level, Z_DEFLATED, coding == GZIP ? 15 + 16 : 15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            throw http::error(INTERNAL_SERVER_ERROR);
+
+        std::string result;
+
+        result.resize(deflateBound(&stream, text.length()));
+
+        stream.next_in = (Bytef *) text.data();
+        stream.avail_in = (uInt) text.length();
+        stream.next_out = (Bytef *) result.data();
+        stream.avail_out = (uInt) result.length();
+
+        int status = deflate(&stream, Z_FINISH);
+
+        deflateEnd(&stream);
+
+        if (status != Z_STREAM_END)
+            throw http::error(INTERNAL_SERVER_ERROR);
+
+        result.resize(stream.total_out);
+
+        return result;
+    }
+
+    std::shared_ptr<const std::string> compress_message(const std::shared_ptr<const std::string> message, const content_coding coding) {
+        if (coding != DEFLATE && coding != GZIP)
+            return message;
+
+        std::string_view text = * message;
+        size_t           end = text.find("\r\n\r\n");
+
+        if (end == std::string_view::npos)
+            return message;
+
+        std::string_view body = text.substr(end + 4);
+
+        if (body.length() < compression_threshold())
+            return message;
+
+        // Copy the status line and headers, less those rewritten below
+        std::string result;
+        std::string vary(strfield(field::ACCEPT_ENCODING));
+        size_t      start = text.find("\r\n") + 2;
+        bool        cacheable = false;
+
+        result.reserve(end + 128);
+        result.append(text.substr(0, start));
+
+        while (start < end + 2) {
+            size_t           eol = text.find("\r\n", start);
+            std::string_view line = text.substr(start, eol - start);
+            size_t           colon = line.find(':');
+
+            start = eol + 2;
+
+            if (colon == std::string_view::npos)
+                continue;
+
+            std::string_view value = line.substr(colon + 1);
+
+            switch (parse_field(line.substr(0, colon))) {
+                case field::CONTENT_ENCODING:
+                case field::TRANSFER_ENCODING:
+                    // Already encoded
+                    return message;
+                case field::CONTENT_LENGTH:
+                    continue;
+                case field::ETAG: {
+                    // Each representation carries its own entity tag
+                    std::string_view tag = trim_view(value);
+
+                    if (tag.length() >= 2 && tag.back() == '"') {
+                        result.append(line.substr(0, colon + 1));
+                        result += " " + std::string(tag.substr(0, tag.length() - 1)) + "-" + strcoding(coding) + "\"\r\n";
+
+                        continue;
+                    }
+
+                    break;
+                }
+                case field::CACHE_CONTROL:
+                    cacheable = value.find("no-store") == std::string_view::npos;
+
+                    break;
+                case field::VARY:
+                    vary = std::string(trim_view(value)) + ", " + vary;
+
+                    continue;
+                default:
+                    break;
+            }
+
+            result.append(line);
+            result.append("\r\n");
+        }
+
+        std::shared_ptr<const std::string> compressed = cacheable ? _memoize(body, coding) : std::make_shared<const std::string>(compress(body, coding, compression_level()));
+
+        // Incompressible
+        if (compressed->length() >= body.length())
+            return message;
+
+        result += "Content-Encoding: " + strcoding(coding) + "\r\n";
+        result += "Vary: " + vary + "\r\n";
+        result += "Content-Length: " + std::to_string(compressed->length()) + "\r\n\r\n";
+        result += * compressed;
+
+        return std::make_shared<const std::string>(std::move(result));
+    }
+
+    int compression_level() {
+        return _compression_level.load();
+    }
+
+    void compression_level(const int value) {
+        _compression_level.store(value);
+    }
+
+    size_t compression_threshold() {
+        return _compression_threshold.load();
+    }
+
+    void compression_threshold(const size_t value) {
+        _compression_threshold.store(value);
+    }
+
+    std::string decompress(const std::string_view text, const content_coding coding, const size_t max_size) {
+        if (coding == IDENTITY)
+            return std::string(text);
+
+        if (coding != DEFLATE && coding != GZIP)
+            throw http::error(BAD_REQUEST);
+
+        z_stream stream;
+
+        memset(&stream, 0, sizeof(stream));
+
+        if (inflateInit2(&stream, coding == GZIP ? 15 + 16 : 15) != Z_OK)
+            throw http::error(INTERNAL_SERVER_ERROR);
+
+        std::string result;
+        int         status = Z_OK;
+
+        stream.next_in = (Bytef *) text.data();
+        stream.avail_in = (uInt) text.length();
+
+        while (status != Z_STREAM_END) {
+            size_t length = result.length();
+
+            if (length >= max_size) {
+                inflateEnd(&stream);
+
+                throw http::error(BAD_REQUEST);
+            }
+
+            result.resize(std::min(length + 16384, max_size));
+
+            stream.next_out = (Bytef *) result.data() + length;
+            stream.avail_out = (uInt) (result.length() - length);
+
+            status = inflate(&stream, Z_NO_FLUSH);
+
+            result.resize(result.length() - stream.avail_out);
+
+            // Truncated or malformed
+            if (status != Z_OK && status != Z_STREAM_END) {
+                inflateEnd(&stream);
+
+                throw http::error(BAD_REQUEST);
+            }
+        }
+
+        inflateEnd(&stream);
+
+        return result;
+    }
+
+    content_coding negotiate_coding(const std::string_view accept_encoding) {
+        // Quality values; < 0 if unlisted
+        double deflate = -1,
+               gzip = -1,
+               other = -1;
+
+        std::string_view value = accept_encoding;
+
+        while (value.length()) {
+            size_t end = value.find(',');
+
+            if (end == std::string_view::npos)
+                end = value.length();
+
+            std::string_view item = value.substr(0, end),
+                             name = item.substr(0, item.find(';'));
+            double           quality = 1;
+            size_t           q = item.find("q=");
+
+            value.remove_prefix(std::min(end + 1, value.length()));
+
+            if (q != std::string_view::npos)
+                quality = atof(std::string(item.substr(q + 2)).c_str());
+
+            name = trim_view(name);
+
+            if (iequals(name, "gzip") || iequals(name, "x-gzip"))
+                gzip = quality;
+            else if (iequals(name, "deflate"))
+                deflate = quality;
+            else if (name == "*")
+                other = quality;
+        }
+
+        if (gzip < 0)
+            gzip = other;
+
+        if (deflate < 0)
+            deflate = other;
+
+        if (gzip > 0 && gzip >= deflate)
+            return GZIP;
+
+        if (deflate > 0)
+            return DEFLATE;
+
+        return IDENTITY;
+    }
+
+    content_coding parse_coding(const std::string_view name) {
+        if (name.empty() || iequals(name, "identity"))
+            return IDENTITY;
+
+        if (iequals(name, "gzip") || iequals(name, "x-gzip"))
+            return GZIP;
+
+        if (iequals(name, "deflate"))
+            return DEFLATE;
+
+        return UNKNOWN_CODING;
+    }
+
+    std::string strcoding(const content_coding coding) {
+        switch (coding) {
+            case IDENTITY:
+                return "identity";
+            case DEFLATE:
+                return "deflate";
+            case GZIP:
+                return "gzip";
+            default:
+                break;
+        }
+
+        return "";
+    }
+}
@@ -0,0 +1,65 @@
+//
+//  compression.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef compression_h
+#define compression_h
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace http {
+    // Typedef
+
+    enum content_coding { IDENTITY, DEFLATE, GZIP, UNKNOWN_CODING };
+
+    // Non-Member Functions
+
+    /**
+     * Return text compressed using coding at level (0-9, or -1 for zlib's default)
+     */
+    std::string                        compress(const std::string_view text, const content_coding coding, const int level);
+
+    /**
+     * Return message with its body compressed using coding, if it's large enough and not already encoded, otherwise return message;
+     * bodies of cacheable messages (having Cache-Control without no-store) are compressed once
+     */
+    std::shared_ptr<const std::string> compress_message(const std::shared_ptr<const std::string> message, const content_coding coding);
+
+    /**
+     * Return the compression level, -1 for zlib's default
+     */
+    int                                compression_level();
+
+    void                               compression_level(const int value);
+
+    /**
+     * Return the minimum size of a body worth compressing
+     */
+    size_t                             compression_threshold();
+
+    void                               compression_threshold(const size_t value);
+
+    /**
+     * Return text decompressed using coding; throw BAD_REQUEST if text is malformed or decompresses to more than max_size bytes
+     */
+    std::string                        decompress(const std::string_view text, const content_coding coding, const size_t max_size);
+
+    /**
+     * Return the preferred coding acceptable per the value of Accept-Encoding
+     */
+    content_coding                     negotiate_coding(const std::string_view accept_encoding);
+
+    /**
+     * Return the coding named name (case-insensitive), otherwise return UNKNOWN_CODING
+     */
+    content_coding                     parse_coding(const std::string_view name);
+
+    std::string                        strcoding(const content_coding coding);
+}
+
+#endif /* compression_h */
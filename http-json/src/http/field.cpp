@@ -0,0 +1,162 @@
+//
+//  field.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "field.h"
+#include <array>
+#include <cstdint>
+
+namespace http {
+    // Non-Member Fields
+
+    // Canonical names, in field order
+    constexpr std::string_view _fields[] = {
+        "Accept",
+        "Accept-Charset",
+        "Accept-Encoding",
+        "Accept-Language",
+        "Accept-Ranges",
+        "Access-Control-Allow-Credentials",
+        "Access-Control-Allow-Headers",
+        "Access-Control-Allow-Methods",
+        "Access-Control-Allow-Origin",
+        "Access-Control-Expose-Headers",
+        "Access-Control-Max-Age",
+        "Access-Control-Request-Headers",
+        "Access-Control-Request-Method",
+        "Age",
+        "Allow",
+        "Authorization",
+        "Cache-Control",
+        "Connection",
+        "Content-Disposition",
+        "Content-Encoding",
+        "Content-Language",
+        "Content-Length",
+        "Content-Range",
+        "Content-Type",
+        "Cookie",
+        "Date",
+        "ETag",
+        "Expect",
+        "Expires",
+        "Forwarded",
+        "Host",
+        "If-Match",
+        "If-Modified-Since",
+        "If-None-Match",
+        "If-Range",
+        "If-Unmodified-Since",
+        "Keep-Alive",
+        "Last-Modified",
+        "Location",
+        "Origin",
+        "Pragma",
+        "Range",
+        "Referer",
+        "Server",
+        "Set-Cookie",
+        "TE",
+        "Trailer",
+        "Transfer-Encoding",
+        "Upgrade",
+        "User-Agent",
+        "Vary",
+        "Via",
+        "WWW-Authenticate",
+        "X-Forwarded-For",
+        "X-Forwarded-Proto",
+        "X-Request-ID"
+    };
+
+    static_assert(std::size(_fields) == static_cast<size_t>(field::UNKNOWN), "field names out of sync with field");
+
+    // Number of hash table slots; a power of 2
+    constexpr size_t _slots = 512;
+
+    // Non-Member Functions
+
+    constexpr char _tolower(const char c) {
+        return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+    }
+
+    // Case-insensitive FNV-1a
+    constexpr uint32_t _hash(const std::string_view name, const uint32_t seed) {
+        uint32_t result = 2166136261u ^ seed;
+
+        for (char c: name) {
+            result ^= static_cast<uint8_t>(_tolower(c));
+            result *= 16777619u;
+        }
+
+        return (result ^ (result >> 16)) & (_slots - 1);
+    }
+
+    constexpr bool _is_perfect(const uint32_t seed) {
+        bool used[_slots] = {};
+
+        for (std::string_view name: _fields) {
+            uint32_t slot = _hash(name, seed);
+
+            if (used[slot])
+                return false;
+
+            used[slot] = true;
+        }
+
+        return true;
+    }
+
+    // Find the first seed that hashes every field name to a distinct slot
+    constexpr uint32_t _perfect_seed() {
+        for (uint32_t seed = 0; seed < 4096; seed++)
+            if (_is_perfect(seed))
+                return seed;
+
+        return UINT32_MAX;
+    }
+
+    constexpr uint32_t _seed = _perfect_seed();
+
+    static_assert(_seed != UINT32_MAX, "no perfect hash seed for field names");
+
+    // Slot to field + 1; 0 marks an empty slot
+    constexpr std::array<uint8_t, _slots> _table = []() {
+        std::array<uint8_t, _slots> result = {};
+
+        for (size_t i = 0; i < std::size(_fields); i++)
+            result[_hash(_fields[i], _seed)] = static_cast<uint8_t>(i + 1);
+
+        return result;
+    }();
+
+    bool iequals(const std::string_view a, const std::string_view b) {
+        if (a.length() != b.length())
+            return false;
+
+        for (size_t i = 0; i < a.length(); i++)
+            if (_tolower(a[i]) != _tolower(b[i]))
+                return false;
+
+        return true;
+    }
+
+    field parse_field(const std::string_view name) {
+        uint8_t value = _table[_hash(name, _seed)];
+
+        if (value == 0 || !iequals(name, _fields[value - 1]))
+            return field::UNKNOWN;
+
+        return static_cast<field>(value - 1);
+    }
+
+    std::string_view strfield(const field value) {
+        if (value == field::UNKNOWN)
+            return "";
+
+        return _fields[static_cast<size_t>(value)];
+    }
+}
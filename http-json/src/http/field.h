@@ -0,0 +1,97 @@
+//
+//  field.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef field_h
+#define field_h
+
+#include <string_view>
+
+namespace http {
+    // Typedef
+
+    /**
+     * Well-known header names; UNKNOWN doubles as the number of known fields
+     */
+    enum class field {
+        ACCEPT,
+        ACCEPT_CHARSET,
+        ACCEPT_ENCODING,
+        ACCEPT_LANGUAGE,
+        ACCEPT_RANGES,
+        ACCESS_CONTROL_ALLOW_CREDENTIALS,
+        ACCESS_CONTROL_ALLOW_HEADERS,
+        ACCESS_CONTROL_ALLOW_METHODS,
+        ACCESS_CONTROL_ALLOW_ORIGIN,
+        ACCESS_CONTROL_EXPOSE_HEADERS,
+        ACCESS_CONTROL_MAX_AGE,
+        ACCESS_CONTROL_REQUEST_HEADERS,
+        ACCESS_CONTROL_REQUEST_METHOD,
+        AGE,
+        ALLOW,
+        AUTHORIZATION,
+        CACHE_CONTROL,
+        CONNECTION,
+        CONTENT_DISPOSITION,
+        CONTENT_ENCODING,
+        CONTENT_LANGUAGE,
+        CONTENT_LENGTH,
+        CONTENT_RANGE,
+        CONTENT_TYPE,
+        COOKIE,
+        DATE,
+        ETAG,
+        EXPECT,
+        EXPIRES,
+        FORWARDED,
+        HOST,
+        IF_MATCH,
+        IF_MODIFIED_SINCE,
+        IF_NONE_MATCH,
+        IF_RANGE,
+        IF_UNMODIFIED_SINCE,
+        KEEP_ALIVE,
+        LAST_MODIFIED,
+        LOCATION,
+        ORIGIN,
+        PRAGMA,
+        RANGE,
+        REFERER,
+        SERVER,
+        SET_COOKIE,
+        TE,
+        TRAILER,
+        TRANSFER_ENCODING,
+        UPGRADE,
+        USER_AGENT,
+        VARY,
+        VIA,
+        WWW_AUTHENTICATE,
+        X_FORWARDED_FOR,
+        X_FORWARDED_PROTO,
+        X_REQUEST_ID,
+        UNKNOWN
+    };
+
+    // Non-Member Functions
+
+    /**
+     * Compare ASCII strings case-insensitively
+     */
+    bool             iequals(const std::string_view a, const std::string_view b);
+
+    /**
+     * Return the well-known field named name (case-insensitive), otherwise return UNKNOWN
+     */
+    field            parse_field(const std::string_view name);
+
+    /**
+     * Return the canonical name of value
+     */
+    std::string_view strfield(const field value);
+}
+
+#endif /* field_h */
@@ -8,8 +8,63 @@
 #include "http.h"
 
 namespace http {
+    // Typedef
+
+    struct _default_headers {
+        // Member Fields
+
+        std::string block;
+        header::map headers;
+    };
+
+    // Non-Member Fields
+
+    std::once_flag                                 _date_flag;
+
+    // Odd while the refresher writes; readers copy the date again if it changed as they read
+    std::atomic<unsigned>                          _date_sequence = 0;
+
+    // Current date, NUL-padded; in words, so that readers racing the refresher don't race on memory
+    std::atomic<uint64_t>                          _date_words[4];
+
+    // Method names, in method_code order
+    constexpr std::string_view                     _methods[] = { "CONNECT", "DELETE", "GET", "HEAD", "OPTIONS", "PATCH", "POST", "PUT", "TRACE" };
+
+    std::shared_ptr<const struct _default_headers> _defaults = std::make_shared<const struct _default_headers>();
+
     // Non-Member Functions
 
+    void _refresh_date() {
+        char     buff[sizeof(_date_words)] = { };
+        time_t   now = time(0);
+        tm       gmtm;
+        unsigned sequence = _date_sequence.load(std::memory_order_relaxed);
+
+        gmtime_r(&now, &gmtm);
+        strftime(buff, sizeof(buff), "%a, %d %b %Y %H:%M:%S GMT", &gmtm);
+
+        _date_sequence.store(sequence + 1, std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < std::size(_date_words); i++) {
+            uint64_t word;
+
+            memcpy(&word, buff + i * sizeof(word), sizeof(word));
+
+            _date_words[i].store(word, std::memory_order_relaxed);
+        }
+
+        _date_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    std::string strmethod(const method_code method) {
+        if (method == UNKNOWN_METHOD)
+            return "";
+
+        return std::string(_methods[method]);
+    }
+
     std::string strstatus(const status_code status) {
         switch (status) {
             case UNKNOWN_ERROR:
@@ -18,8 +73,12 @@ namespace http {
                 return "OK";
             case NO_CONTENT:
                 return "No Content";
+            case PARTIAL_CONTENT:
+                return "Partial Content";
             case FOUND:
                 return "Found";
+            case NOT_MODIFIED:
+                return "Not Modified";
             case TEMPORARY_REDIRECT:
                 return "Temporary Redirect";
             case PERMANENT_REDIRECT:
@@ -30,8 +89,16 @@ namespace http {
                 return "Unauthorized";
             case NOT_FOUND:
                 return "Not Found";
+            case CONTENT_TOO_LARGE:
+                return "Content Too Large";
+            case RANGE_NOT_SATISFIABLE:
+                return "Range Not Satisfiable";
+            case REQUEST_HEADER_FIELDS_TOO_LARGE:
+                return "Request Header Fields Too Large";
             case INTERNAL_SERVER_ERROR:
                 return "Internal Server Error";
+            case SERVICE_UNAVAILABLE:
+                return "Service Unavailable";
             default:
                 break;
         }
@@ -39,56 +106,260 @@ namespace http {
         return "";
     }
 
+    std::string chunk(const std::string_view text) {
+        char                 buff[16];
+        std::to_chars_result result = std::to_chars(buff, buff + sizeof(buff), text.length(), 16);
+        std::string          value(buff, result.ptr - buff);
+
+        value += "\r\n";
+        value += text;
+        value += "\r\n";
+
+        return value;
+    }
+
+    fixdate date() {
+        std::call_once(_date_flag, []() {
+            _refresh_date();
+
+            std::thread([]() {
+                while (true) {
+                    // Wake on the next second boundary
+                    auto now = std::chrono::system_clock::now();
+
+                    std::this_thread::sleep_until(std::chrono::ceil<std::chrono::seconds>(now + std::chrono::milliseconds(1)));
+
+                    _refresh_date();
+                }
+            }).detach();
+        });
+
+        char buff[sizeof(_date_words)];
+
+        while (true) {
+            unsigned sequence = _date_sequence.load(std::memory_order_acquire);
+
+            for (size_t i = 0; i < std::size(_date_words); i++) {
+                uint64_t word = _date_words[i].load(std::memory_order_relaxed);
+
+                memcpy(buff + i * sizeof(word), &word, sizeof(word));
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (!(sequence & 1) && sequence == _date_sequence.load(std::memory_order_relaxed))
+                break;
+        }
+
+        fixdate result;
+
+        memcpy(result.value.data(), buff, result.value.size());
+
+        return result;
+    }
+
+    std::string date(const time_t time) {
+        char buff[32];
+        tm   gmtm;
+
+        gmtime_r(&time, &gmtm);
+
+        return std::string(buff, strftime(buff, sizeof(buff), "%a, %d %b %Y %H:%M:%S GMT", &gmtm));
+    }
+
+    header::map default_headers() {
+        return std::atomic_load(&_defaults)->headers;
+    }
+
+    void default_headers(const header::map headers) {
+        std::shared_ptr<struct _default_headers> defaults = std::make_shared<struct _default_headers>();
+
+        defaults->headers = headers;
+
+        for (const auto& [key, value]: headers)
+            defaults->block += key + ": " + value.str() + "\r\n";
+
+        std::atomic_store(&_defaults, std::shared_ptr<const struct _default_headers>(defaults));
+    }
+
+    std::string etag(const std::string_view body) {
+        char                 buff[18] = { '"' };
+        std::to_chars_result result = std::to_chars(buff + 1, buff + sizeof(buff), xxhash64(body), 16);
+
+        return std::string(buff, result.ptr - buff) + '"';
+    }
+
+    std::string_view find_header(const std::string_view message, const field name) {
+        size_t start = message.find("\r\n"),
+               end = message.find("\r\n\r\n");
+
+        if (start == std::string_view::npos || end == std::string_view::npos)
+            return "";
+
+        // Skip the start line, then visit each field line
+        for (start += 2; start < end + 2; ) {
+            size_t           eol = message.find("\r\n", start);
+            std::string_view line = message.substr(start, eol - start);
+            size_t           colon = line.find(':');
+
+            if (colon != std::string_view::npos && parse_field(line.substr(0, colon)) == name)
+                return trim_view(line.substr(colon + 1));
+
+            start = eol + 2;
+        }
+
+        return "";
+    }
+
     std::string http_version() {
         return "HTTP/1.1";
     }
 
+    size_t max_body_size() {
+        return 8 * 1024 * 1024;
+    }
+
+    // Compare entity tags weakly, ignoring content coding suffixes
+    bool _etag_matches(const std::string_view value, const std::string_view etag) {
+        auto opaque = [](std::string_view tag) {
+            tag = trim_view(tag);
+
+            if (tag.substr(0, 2) == "W/")
+                tag.remove_prefix(2);
+
+            for (content_coding coding: { DEFLATE, GZIP }) {
+                std::string suffix = "-" + strcoding(coding) + "\"";
+
+                if (tag.length() > suffix.length() && tag.ends_with(suffix))
+                    return std::string(tag.substr(0, tag.length() - suffix.length())) + "\"";
+            }
+
+            return std::string(tag);
+        };
+
+        if (trim_view(value) == "*")
+            return true;
+
+        std::string      target = opaque(etag);
+        std::string_view list = value;
+
+        while (list.length()) {
+            size_t end = list.find(',');
+
+            if (end == std::string_view::npos)
+                end = list.length();
+
+            if (opaque(list.substr(0, end)) == target)
+                return true;
+
+            list.remove_prefix(std::min(end + 1, list.length()));
+        }
+
+        return false;
+    }
+
+    std::shared_ptr<const std::string> tag_message(const request& request, const std::shared_ptr<const std::string> message) {
+        method_code method = parse_method(request.method());
+
+        if (method != GET && method != HEAD)
+            return message;
+
+        std::string_view text = * message;
+        size_t           end = text.find("\r\n\r\n");
+
+        if (end == std::string_view::npos || text.substr(0, status_line(OK).length()) != status_line(OK))
+            return message;
+
+        std::shared_ptr<const std::string> result = message;
+        std::string_view                   value = find_header(text, field::ETAG);
+
+        if (value.empty()) {
+            std::string tag = etag(text.substr(end + 4)),
+                        tagged;
+
+            tagged.reserve(text.length() + tag.length() + 8);
+            tagged.append(text.substr(0, end + 2));
+            tagged += "ETag: " + tag + "\r\n";
+            tagged.append(text.substr(end + 2));
+
+            result = std::make_shared<const std::string>(std::move(tagged));
+            text = * result;
+            end = text.find("\r\n\r\n");
+            value = find_header(text, field::ETAG);
+        }
+
+        const header_view& if_none_match = request.headers()[field::IF_NONE_MATCH];
+
+        if (if_none_match.empty() || !_etag_matches(if_none_match, value))
+            return result;
+
+        // Keep headers, less those framing the body
+        std::string not_modified(status_line(NOT_MODIFIED));
+
+        for (size_t start = text.find("\r\n") + 2; start < end + 2; ) {
+            size_t           eol = text.find("\r\n", start);
+            std::string_view line = text.substr(start, eol - start);
+            field            name = parse_field(line.substr(0, line.find(':')));
+
+            if (name != field::CONTENT_LENGTH && name != field::TRANSFER_ENCODING)
+                not_modified.append(text.substr(start, eol + 2 - start));
+
+            start = eol + 2;
+        }
+
+        not_modified += "\r\n";
+
+        return std::make_shared<const std::string>(std::move(not_modified));
+    }
+
     size_t timeout() {
         return 30;
     }
 
-    request parse_request(const std::string message) {
-#if LOGGING == LEVEL_DEBUG
-        std::cout << message << std::endl;
-#endif
+    bool is_chunked(const std::string_view value) {
+        size_t start = value.rfind(',');
 
-        std::istringstream iss(message);
-        std::string        str;
+        return iequals(trim_view(start == std::string_view::npos ? value : value.substr(start + 1)), "chunked");
+    }
 
-        getline(iss, str);
+    size_t message_length(const std::string_view buffer) {
+        message_framer framer;
 
-        std::vector<std::string> tokens = ::tokens(str);
+        return framer.length(buffer);
+    }
 
-        if (!(tokens.size() == 3 && tokens[2] == http_version()))
-            throw http::error(BAD_REQUEST);
+    time_t parse_date(const std::string_view value) {
+        std::string text(trim_view(value));
 
-        std::string method = tolowerstr(tokens[0]),
-                     target = tokens[1];
-        header::map headers;
+        // IMF-fixdate, then RFC 850 and asctime()'s formats
+        for (const char* format: { "%a, %d %b %Y %H:%M:%S GMT", "%A, %d-%b-%y %H:%M:%S GMT", "%a %b %e %H:%M:%S %Y" }) {
+            tm gmtm;
 
-        while (getline(iss, str)) {
-            std::vector<std::string> header = split(str, ":");
+            memset(&gmtm, 0, sizeof(gmtm));
 
-            if (header.size() == 1)
-                break;
+            const char* end = strptime(text.c_str(), format, &gmtm);
 
-            headers[tolowerstr(header[0])] = trim(str.substr(header[0].length() + 1));
+            if (end && !* end)
+                return timegm(&gmtm);
         }
 
-        int         content_length = headers["content-length"];
-        std::string body = "";
+        return -1;
+    }
 
-        if (content_length != INT_MIN) {
-            std::vector<std::string> value;
+    request parse_request(std::string message) {
+#if LOGGING == LEVEL_DEBUG
+        std::cout << message << std::endl;
+#endif
 
-            while (getline(iss, str))
-                value.push_back(trim_end(str));
+        return request(std::move(message));
+    }
 
-            body = join(value, "\r\n");
-            body = body.substr(0, std::min((int) body.length(), content_length));
-        }
+    method_code parse_method(const std::string_view name) {
+        for (size_t i = 0; i < UNKNOWN_METHOD; i++)
+            if (iequals(name, _methods[i]))
+                return static_cast<method_code>(i);
 
-        return request(method, target, headers, body);
+        return UNKNOWN_METHOD;
     }
 
     std::string redirect(header::map& headers, const status_code status, const std::string location) {
@@ -103,54 +374,66 @@ namespace http {
         return redirect(headers, FOUND, location);
     }
 
-    std::string response(const std::string text, header::map headers) {
+    std::string response(const std::string text, const header::map& headers) {
         return response(OK, strstatus(OK), text, headers);
     }
 
-    std::string response(const status_code status, const std::string status_text, const std::string text, header::map headers, const bool date) {
-        std::ostringstream oss(http_version() + " ");
+    std::string response(const status_code status, const std::string status_text, const std::string text, const header::map& headers, const bool date) {
+        thread_local response_builder builder;
 
-        oss.seekp(0, std::ios::end);
+        builder.clear();
+        builder.status(status, status_text);
 
-        oss << std::to_string(status) << " " << status_text << "\r\n";
+        if (date)
+            builder.date();
 
-        // Response headers
-        if (date) {
-            time_t now = time(0);
-            tm*    gmtm = gmtime(&now);
-            char*  dt = asctime(gmtm);
-            
-            std::vector<std::string> tokens = ::tokens(std::string(dt));
+        builder.headers(headers);
 
-            oss << "Date" << ": ";
+        header::map::const_iterator transfer_encoding = headers.find("Transfer-Encoding");
 
-            std::string day = tokens[0],
-                         month = tokens[1],
-                         date = tokens[2],
-                         time = tokens[3],
-                         year = tokens[4];
+        if (transfer_encoding == headers.end())
+            builder.body(text);
+        else if (is_chunked(transfer_encoding->second.str()))
+            builder.body(text.empty() ? chunk("") : chunk(text) + chunk(""), false);
+        else
+            builder.body(text, false);
 
-            oss << day << ", " << date << " " << month << " " << year << " " << time << " GMT";
-        }
+        return builder.str();
+    }
 
-        for (const auto& [key, value]: headers) {
-            oss << "\r\n";
-            oss << key << ": " << value.str();
+    std::string_view status_line(const status_code status) {
+        switch (status) {
+            case OK:
+                return "HTTP/1.1 200 OK\r\n";
+            case NO_CONTENT:
+                return "HTTP/1.1 204 No Content\r\n";
+            case PARTIAL_CONTENT:
+                return "HTTP/1.1 206 Partial Content\r\n";
+            case FOUND:
+                return "HTTP/1.1 302 Found\r\n";
+            case NOT_MODIFIED:
+                return "HTTP/1.1 304 Not Modified\r\n";
+            case TEMPORARY_REDIRECT:
+                return "HTTP/1.1 307 Temporary Redirect\r\n";
+            case PERMANENT_REDIRECT:
+                return "HTTP/1.1 308 Permanent Redirect\r\n";
+            case BAD_REQUEST:
+                return "HTTP/1.1 400 Bad Request\r\n";
+            case UNAUTHORIZED:
+                return "HTTP/1.1 401 Unauthorized\r\n";
+            case NOT_FOUND:
+                return "HTTP/1.1 404 Not Found\r\n";
+            case RANGE_NOT_SATISFIABLE:
+                return "HTTP/1.1 416 Range Not Satisfiable\r\n";
+            case INTERNAL_SERVER_ERROR:
+                return "HTTP/1.1 500 Internal Server Error\r\n";
+            case SERVICE_UNAVAILABLE:
+                return "HTTP/1.1 503 Service Unavailable\r\n";
+            default:
+                break;
         }
-        
-        if (text.length()) {
-            if (headers["Transfer-Encoding"].str().empty()) {
-                headers.erase("Transfer-Encoding");
-                
-                oss << "\r\n";
-                oss << "Content-Length: " << text.length();
-            }
 
-            oss << "\r\n\r\n";
-            oss << text;
-        }
-        
-        return oss.str();
+        return "";
     }
 
     // Constructors
@@ -187,19 +470,258 @@ namespace http {
         this->_set(value);
     }
 
-    request::request(const std::string method, const std::string url, header::map headers, const std::string body) {
-        this->_method = method;
+    header_view::header_view() { }
+
+    header_view::header_view(const std::string_view value) {
+        this->_value = value;
+    }
+
+    request::request(std::string message) {
+        this->_message = std::move(message);
+
+        std::string_view text = this->_message;
+        size_t           start = 0;
+
+        // Advance past the next line, excluding its terminator
+        auto getline = [&text, &start](std::string_view& line) {
+            if (start == text.length())
+                return false;
+
+            size_t end = text.find('\n', start);
+
+            if (end == std::string_view::npos)
+                end = text.length();
+
+            line = text.substr(start, end - start);
+
+            if (line.length() && line.back() == '\r')
+                line.remove_suffix(1);
+
+            start = std::min(end + 1, text.length());
+
+            return true;
+        };
+
+        std::string_view line,
+                         tokens[3];
+        size_t           ntokens = 0;
+
+        if (!getline(line))
+            throw http::error(BAD_REQUEST);
+
+        for (size_t i = 0; i < line.length(); ) {
+            while (i < line.length() && isspace(line[i]))
+                i++;
+
+            if (i == line.length())
+                break;
+
+            size_t j = i;
 
-        class url url_obj(url);
+            while (j < line.length() && !isspace(line[j]))
+                j++;
+
+            if (ntokens == 3)
+                throw http::error(BAD_REQUEST);
+
+            tokens[ntokens++] = line.substr(i, j - i);
+            i = j;
+        }
+
+        if (!(ntokens == 3 && tokens[2] == http_version()))
+            throw http::error(BAD_REQUEST);
+
+        this->_method = tolowerstr(std::string(tokens[0]));
+
+        class url url_obj = std::string(tokens[1]);
 
         this->_url = url_obj.target();
         this->_params = url_obj.params();
-        this->_headers = headers;
-        this->_body = body;
+
+        while (getline(line)) {
+            size_t colon = line.find(':');
+
+            if (colon == std::string_view::npos)
+                break;
+
+            this->_headers.insert(line.substr(0, colon), trim_view(line.substr(colon + 1)));
+        }
+
+        if (is_chunked(this->_headers[field::TRANSFER_ENCODING])) {
+            // Decoded data is never longer than its encoding; decode in place
+            char*         data = this->_message.data() + start;
+            size_t        length = 0;
+            chunk_decoder decoder;
+
+            decoder.decode(text.substr(start), [data, &length](const std::string_view value) {
+                memmove(data + length, value.data(), value.length());
+
+                length += value.length();
+            });
+
+            if (!decoder.done())
+                throw http::error(BAD_REQUEST);
+
+            this->_body = std::string_view(data, length);
+        } else {
+            int content_length = this->_headers[field::CONTENT_LENGTH];
+
+            if (content_length > 0)
+                this->_body = text.substr(start, content_length);
+        }
+
+        content_coding coding = parse_coding(this->_headers[field::CONTENT_ENCODING]);
+
+        if (coding == UNKNOWN_CODING)
+            throw http::error(BAD_REQUEST);
+
+        if (coding == IDENTITY || this->_body.empty())
+            return;
+
+        // Append the decoded body to the message; appending may reallocate
+        std::string body = decompress(this->_body, coding, max_body_size());
+        const char* data = this->_message.data();
+        size_t      offset = this->_message.length();
+
+        this->_message += body;
+        this->_rebase(data);
+        this->_body = std::string_view(this->_message).substr(offset);
+    }
+
+    static_response::static_response() {
+        this->_messages[IDENTITY] = std::make_shared<const std::string>();
+    }
+
+    static_response::static_response(const status_code status, const std::string text, const header::map& headers) {
+        response_builder builder;
+
+        builder.status(status);
+
+        size_t offset = builder.str().length();
+
+        builder.date();
+
+        this->_date_offset = offset + std::string_view("Date: ").length();
+
+        builder.headers(headers);
+
+        // Body is constant, so its tag is too
+        if (status == OK && text.length())
+            builder.header(strfield(field::ETAG), etag(text));
+
+        builder.body(text);
+
+        this->_messages[IDENTITY] = std::make_shared<const std::string>(builder.str());
+
+        // Added headers follow the Date header, so its offset is unchanged
+        for (content_coding coding: { DEFLATE, GZIP }) {
+            std::shared_ptr<const std::string> message = compress_message(this->_messages[IDENTITY], coding);
+
+            if (message != this->_messages[IDENTITY])
+                this->_messages[coding] = message;
+        }
+    }
+
+    request::request(const request& other) {
+        *this = other;
+    }
+
+    request::request(request&& other) {
+        *this = std::move(other);
     }
 
     // Operators
 
+    const header_view& header_view::map::operator[](const field key) const {
+        if (key != field::UNKNOWN)
+            return this->_fields[static_cast<size_t>(key)];
+
+        // Thread-local; lazily interpreted values are cached on access
+        thread_local const header_view empty;
+
+        return empty;
+    }
+
+    const header_view& header_view::map::operator[](const std::string_view key) const {
+        field value = parse_field(key);
+
+        if (value != field::UNKNOWN)
+            return (*this)[value];
+
+        for (const auto& [name, header]: this->_values)
+            if (iequals(name, key))
+                return header;
+
+        return (*this)[field::UNKNOWN];
+    }
+
+    header_view::operator int() const {
+        return this->int_value();
+    }
+
+    header_view::operator std::string() const {
+        return this->str();
+    }
+
+    header_view::operator std::string_view() const {
+        return this->value();
+    }
+
+    fixdate::operator std::string_view() const {
+        return std::string_view(this->value.data(), this->value.size());
+    }
+
+    bool header_view::operator==(const char* value) const {
+        return this->value() == value;
+    }
+
+    bool header_view::operator==(const int value) const {
+        return this->int_value() == value;
+    }
+
+    bool header_view::operator==(const std::string_view value) const {
+        return this->value() == value;
+    }
+
+    bool header_view::operator!=(const char* value) const {
+        return !(*this == value);
+    }
+
+    bool header_view::operator!=(const int value) const {
+        return !(*this == value);
+    }
+
+    bool header_view::operator!=(const std::string_view value) const {
+        return !(*this == value);
+    }
+
+    request& request::operator=(const request& other) {
+        this->_message = other._message;
+        this->_body = other._body;
+        this->_headers = other._headers;
+        this->_method = other._method;
+        this->_params = other._params;
+        this->_url = other._url;
+        this->_rebase(other._message.data());
+
+        return *this;
+    }
+
+    request& request::operator=(request&& other) {
+        // Short strings move by copy; capture the source address before moving
+        const char* data = other._message.data();
+
+        this->_message = std::move(other._message);
+        this->_body = other._body;
+        this->_headers = std::move(other._headers);
+        this->_method = std::move(other._method);
+        this->_params = std::move(other._params);
+        this->_url = std::move(other._url);
+        this->_rebase(data);
+
+        return *this;
+    }
+
     header::operator int() {
         return this->int_value();
     }
@@ -292,30 +814,438 @@ namespace http {
         return this->list();
     }
 
-    std::string request::body() const {
+    void request::_rebase(const char* data) {
+        auto rebase = [&](std::string_view& value) {
+            if (value.data() >= data && value.data() <= data + this->_message.length())
+                value = std::string_view(this->_message.data() + (value.data() - data), value.length());
+        };
+
+        rebase(this->_body);
+
+        for (header_view& value: this->_headers._fields)
+            rebase(value._value);
+
+        for (auto& [key, value]: this->_headers._values) {
+            rebase(key);
+            rebase(value._value);
+        }
+    }
+
+    response_builder& response_builder::body(const std::string_view text, const bool content_length) {
+        // No Content and Not Modified responses are bodiless
+        if (content_length && this->_status != NO_CONTENT && this->_status != NOT_MODIFIED) {
+            char                 buff[20];
+            std::to_chars_result result = std::to_chars(buff, buff + sizeof(buff), text.length());
+
+            this->header("Content-Length", std::string_view(buff, result.ptr - buff));
+        }
+
+        this->_buffer += "\r\n";
+        this->_buffer += text;
+
+        return *this;
+    }
+
+    std::string_view request::body() const {
         return this->_body;
     }
 
-    header::map request::headers() {
+    size_t message_framer::_chunked_length(const std::string_view buffer) {
+        this->_decoded += this->_decoder.decode(buffer.substr(this->_head + this->_decoded), [](const std::string_view) { });
+
+        return this->_decoder.done() ? this->_decoded : 0;
+    }
+
+    void response_builder::clear() {
+        this->_buffer.clear();
+    }
+
+    bool header_view::map::contains(const field key) const {
+        // Present headers view the message, even when empty
+        return key != field::UNKNOWN && this->_fields[static_cast<size_t>(key)].value().data() != NULL;
+    }
+
+    bool header_view::map::contains(const std::string_view key) const {
+        field value = parse_field(key);
+
+        if (value != field::UNKNOWN)
+            return this->contains(value);
+
+        for (const auto& [name, header]: this->_values)
+            if (iequals(name, key))
+                return true;
+
+        return false;
+    }
+
+    size_t chunk_decoder::decode(const std::string_view text, const std::function<void(const std::string_view)> consumer) {
+        size_t i = 0;
+
+        while (i < text.length() && this->_state != DONE) {
+            char c = text[i];
+
+            switch (this->_state) {
+                case SIZE:
+                    if (isxdigit(c)) {
+                        if (this->_size > (SIZE_MAX >> 4))
+                            throw http::error(BAD_REQUEST);
+
+                        this->_size = (this->_size << 4) | (isdigit(c) ? c - '0' : tolower(c) - 'a' + 10);
+                        this->_digits++;
+
+                        i++;
+
+                        break;
+                    }
+
+                    if (!this->_digits)
+                        throw http::error(BAD_REQUEST);
+
+                    this->_state = EXTENSION;
+
+                    break;
+                case EXTENSION:
+                    // Ignore chunk extensions
+                    if (c == '\n') {
+                        this->_digits = 0;
+                        this->_line_length = 0;
+                        this->_state = this->_size ? DATA : TRAILER;
+                    }
+
+                    i++;
+
+                    break;
+                case DATA: {
+                    size_t length = std::min(this->_size, text.length() - i);
+
+                    consumer(text.substr(i, length));
+
+                    i += length;
+
+                    this->_size -= length;
+
+                    if (!this->_size)
+                        this->_state = DATA_END;
+
+                    break;
+                }
+                case DATA_END:
+                    if (c == '\n')
+                        this->_state = SIZE;
+                    else if (c != '\r')
+                        throw http::error(BAD_REQUEST);
+
+                    i++;
+
+                    break;
+                case TRAILER:
+                    // Ignore trailer fields up to the empty line
+                    if (c == '\n') {
+                        if (!this->_line_length)
+                            this->_state = DONE;
+
+                        this->_line_length = 0;
+                    } else if (c != '\r')
+                        this->_line_length++;
+
+                    i++;
+
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        return i;
+    }
+
+    response_builder& response_builder::date() {
+        return this->header("Date", http::date());
+    }
+
+    bool chunk_decoder::done() const {
+        return this->_state == DONE;
+    }
+
+    bool header_view::empty() const {
+        return this->_value.empty();
+    }
+
+    bool message_framer::_find_head(const std::string_view buffer) {
+        // A line break, then an empty line; bare LFs are tolerated
+        for (size_t i = buffer.find('\n', this->_searched); i != std::string_view::npos; i = buffer.find('\n', i + 1)) {
+            size_t next = i + 1;
+
+            if (next < buffer.length() && buffer[next] == '\r')
+                next++;
+
+            if (next == buffer.length()) {
+                // Resume here once more arrives
+                this->_searched = i;
+
+                return false;
+            }
+
+            if (buffer[next] == '\n') {
+                this->_head = next + 1;
+
+                return true;
+            }
+        }
+
+        this->_searched = buffer.length();
+
+        return false;
+    }
+
+    response_builder& response_builder::header(const std::string_view key, const std::string_view value) {
+        this->_buffer += key;
+        this->_buffer += ": ";
+        this->_buffer += value;
+        this->_buffer += "\r\n";
+
+        return *this;
+    }
+
+    const header_view::map& request::headers() const {
         return this->_headers;
     }
 
+    response_builder& response_builder::headers(const http::header::map& headers) {
+        std::shared_ptr<const struct _default_headers> defaults = std::atomic_load(&_defaults);
+
+        auto overrides = [&headers](const std::string_view key) {
+            for (const auto& [name, value]: headers)
+                if (iequals(name, key))
+                    return true;
+
+            return false;
+        };
+
+        bool overridden = false;
+
+        for (const auto& [key, value]: defaults->headers)
+            if (overrides(key)) {
+                overridden = true;
+
+                break;
+            }
+
+        if (overridden) {
+            for (const auto& [key, value]: defaults->headers)
+                if (!overrides(key))
+                    this->header(key, value.str());
+        } else
+            this->_buffer += defaults->block;
+
+        for (const auto& [key, value]: headers)
+            this->header(key, value.str());
+
+        return *this;
+    }
+
+    void header_view::map::insert(const std::string_view key, const std::string_view value) {
+        field name = parse_field(key);
+
+        // Last occurrence wins
+        if (name != field::UNKNOWN) {
+            this->_fields[static_cast<size_t>(name)] = header_view(value);
+
+            return;
+        }
+
+        for (auto& [other, header]: this->_values)
+            if (iequals(other, key)) {
+                header = header_view(value);
+
+                return;
+            }
+
+        this->_values.push_back({ key, header_view(value) });
+    }
+
     int header::int_value() const {
         return this->_int;
     }
 
+    int header_view::int_value() const {
+        if (!this->_int.has_value()) {
+            std::string_view value = this->value();
+
+            if (value.length() > 1 && value[0] == '+')
+                value.remove_prefix(1);
+
+            int                    result;
+            std::from_chars_result status = std::from_chars(value.data(), value.data() + value.length(), result);
+
+            this->_int = value.length() && status.ec == std::errc() && status.ptr == value.data() + value.length() ? result : INT_MIN;
+        }
+
+        return this->_int.value();
+    }
+
+    size_t message_framer::length(const std::string_view buffer) {
+        if (!this->_head) {
+            if (!this->_find_head(buffer))
+                return 0;
+
+            // Skip the request line
+            for (size_t start = buffer.find('\n') + 1; start < this->_head; ) {
+                size_t           eol = buffer.find('\n', start);
+                std::string_view line = buffer.substr(start, eol - start);
+                size_t           colon = line.find(':');
+
+                if (colon != std::string_view::npos) {
+                    field name = parse_field(trim_view(line.substr(0, colon)));
+
+                    if (name == field::CONTENT_LENGTH) {
+                        int value = header_view(trim_view(line.substr(colon + 1))).int_value();
+
+                        // Recipients choosing different values would disagree on where the next message begins
+                        if (value < 0 || (this->_content_length != -1 && value != this->_content_length))
+                            throw http::error(BAD_REQUEST);
+
+                        this->_content_length = value;
+                    } else if (name == field::TRANSFER_ENCODING)
+                        this->_chunked = is_chunked(line.substr(colon + 1));
+                }
+
+                start = eol + 1;
+            }
+        }
+
+        size_t length = this->_head;
+
+        // Transfer-Encoding overrides Content-Length
+        if (this->_chunked) {
+            size_t body = this->_chunked_length(buffer);
+
+            if (!body)
+                return 0;
+
+            length += body;
+        } else {
+            length += std::max(this->_content_length, 0);
+
+            if (length > buffer.length())
+                return 0;
+        }
+
+        // The next call frames the next message
+        * this = message_framer();
+
+        return length;
+    }
+
     std::set<std::string> header::list() {
         return this->_list;
     }
 
-    std::string request::method() const {
+    const std::set<std::string>& header_view::list() const {
+        if (!this->_list.has_value()) {
+            std::set<std::string> result;
+            std::string_view      value = this->value();
+
+            while (value.length()) {
+                size_t end = value.find(',');
+
+                if (end == std::string_view::npos)
+                    end = value.length();
+
+                result.insert(std::string(trim_view(value.substr(0, end))));
+                value.remove_prefix(std::min(end + 1, value.length()));
+            }
+
+            this->_list = std::move(result);
+        }
+
+        return this->_list.value();
+    }
+
+    response_builder& response_builder::status(const status_code status) {
+        std::string_view line = status_line(status);
+
+        if (line.empty())
+            return this->status(status, strstatus(status));
+
+        this->_status = status;
+        this->_buffer += line;
+
+        return *this;
+    }
+
+    response_builder& response_builder::status(const status_code status, const std::string_view status_text) {
+        std::string_view line = status_line(status);
+
+        // "HTTP/1.1 200 " precedes the status text
+        size_t prefix = http_version().length() + 5;
+
+        if (line.length() && line.substr(prefix, line.length() - prefix - 2) == status_text)
+            return this->status(status);
+
+        this->_status = status;
+        this->_buffer += http_version();
+        this->_buffer += " ";
+        this->_buffer += std::to_string(status);
+        this->_buffer += " ";
+        this->_buffer += status_text;
+        this->_buffer += "\r\n";
+
+        return *this;
+    }
+
+    const std::string& response_builder::str() const {
+        return this->_buffer;
+    }
+
+    std::shared_ptr<const std::string> static_response::message(const content_coding coding) const {
+        size_t                             index = coding < UNKNOWN_CODING ? coding : IDENTITY;
+
+        // Stored concurrently; load each slot once
+        std::shared_ptr<const std::string> result = std::atomic_load(&this->_messages[index]);
+
+        // Not precompressed in this coding
+        if (!result) {
+            index = IDENTITY;
+            result = std::atomic_load(&this->_messages[index]);
+        }
+
+        fixdate          current = date();
+        std::string_view now = current;
+
+        if (result->empty() || std::string_view(* result).substr(this->_date_offset, now.length()) == now)
+            return result;
+
+        // Published messages are immutable; splice into a copy
+        std::shared_ptr<std::string> message = std::make_shared<std::string>(* result);
+
+        message->replace(this->_date_offset, now.length(), now);
+
+        result = message;
+
+        std::atomic_store(&this->_messages[index], result);
+
+        return result;
+    }
+
+    const std::string& request::method() const {
         return this->_method;
     }
 
-    url::param::map request::params() {
+    const url::param::map& request::params() const {
         return this->_params;
     }
 
+    size_t header_view::map::size() const {
+        size_t result = this->_values.size();
+
+        for (const header_view& header: this->_fields)
+            if (header.value().data() != NULL)
+                result++;
+
+        return result;
+    }
+
     status_code error::status() const {
         return this->_status;
     }
@@ -328,14 +1258,22 @@ namespace http {
         return this->_str;
     }
 
+    std::string header_view::str() const {
+        return std::string(this->value());
+    }
+
     std::string error::text() const {
         return this->_text;
     }
 
-    std::string request::url() const {
+    const std::string& request::url() const {
         return this->_url;
     }
 
+    std::string_view header_view::value() const {
+        return this->_value;
+    }
+
     const char* error::what() const throw() {
         return this->_text.c_str();
     }
@@ -8,29 +8,90 @@
 #ifndef http_h
 #define http_h
 
+#include "compression.h"
+#include "field.h"
 #include "logger.h"
 #include "url.h"
 #include "util.h"
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <climits>
 #include <cmath>
+#include <functional>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
+#include <string_view>
+#include <thread>
 
 namespace http {
     // Typedef
 
+    enum method_code {
+        CONNECT,
+        DELETE,
+        GET,
+        HEAD,
+        OPTIONS,
+        PATCH,
+        POST,
+        PUT,
+        TRACE,
+        UNKNOWN_METHOD
+    };
+
     enum status_code {
         UNKNOWN_ERROR = 0,
         OK = 200,
         NO_CONTENT = 204,
+        PARTIAL_CONTENT = 206,
         FOUND = 302,
+        NOT_MODIFIED = 304,
         TEMPORARY_REDIRECT = 307,
         PERMANENT_REDIRECT = 308,
         BAD_REQUEST = 400,
         UNAUTHORIZED = 401,
         NOT_FOUND = 404,
+        CONTENT_TOO_LARGE = 413,
+        RANGE_NOT_SATISFIABLE = 416,
+        REQUEST_HEADER_FIELDS_TOO_LARGE = 431,
         INTERNAL_SERVER_ERROR = 500,
+        SERVICE_UNAVAILABLE = 503,
     };
 
 
+    /**
+     * Incremental decoder for the chunked transfer coding
+     */
+    struct chunk_decoder {
+        // Member Functions
+
+        /**
+         * Decode as much of text as possible, passing chunk data to consumer, and return the number of bytes consumed;
+         * throw BAD_REQUEST if text is malformed
+         */
+        size_t decode(const std::string_view text, const std::function<void(const std::string_view)> consumer);
+
+        /**
+         * Return true if the last chunk and trailer section have been decoded
+         */
+        bool   done() const;
+    private:
+        // Typedef
+
+        enum state { SIZE, EXTENSION, DATA, DATA_END, TRAILER, DONE };
+
+        // Member Fields
+
+        size_t _digits = 0;
+        size_t _line_length = 0;
+        size_t _size = 0;
+        state  _state = SIZE;
+    };
+
     struct error: public std::exception {
         // Constructors
 
@@ -55,6 +116,19 @@ namespace http {
         std::string _text;
     };
 
+    /**
+     * IMF-fixdate, held by value so that it outlives the shared date's refresh
+     */
+    struct fixdate {
+        // Member Fields
+
+        std::array<char, 29> value;
+
+        // Member Functions
+
+        operator std::string_view() const;
+    };
+
     struct header {
         // Typedef
 
@@ -125,49 +199,350 @@ namespace http {
         std::set<std::string> _set(std::set<std::string> value);
     };
 
+    struct request;
+
+    /**
+     * Request header; a view into the request's receive buffer, interpreted on access
+     */
+    struct header_view {
+        // Typedef
+
+        class map;
+
+        // Constructors
+
+        header_view();
+
+        header_view(const std::string_view value);
+
+        // Operators
+
+        operator                     int() const;
+
+        operator                     std::string() const;
+
+        operator                     std::string_view() const;
+
+        bool                         operator==(const char* value) const;
+
+        bool                         operator==(const int value) const;
+
+        bool                         operator==(const std::string_view value) const;
+
+        bool                         operator!=(const char* value) const;
+
+        bool                         operator!=(const int value) const;
+
+        bool                         operator!=(const std::string_view value) const;
+
+        // Member Functions
+
+        bool                         empty() const;
+
+        int                          int_value() const;
+
+        const std::set<std::string>& list() const;
+
+        std::string                  str() const;
+
+        std::string_view             value() const;
+    private:
+        // Typedef
+
+        friend request;
+
+        // Member Fields
+
+        mutable std::optional<int>                   _int;
+        mutable std::optional<std::set<std::string>> _list;
+        std::string_view                             _value;
+    };
+
+    /**
+     * Well-known headers live in fixed slots indexed by field; others in an overflow list
+     */
+    class header_view::map {
+        // Member Fields
+
+        std::array<header_view, static_cast<size_t>(field::UNKNOWN)> _fields;
+        std::vector<std::pair<std::string_view, header_view>>         _values;
+    public:
+        // Typedef
+
+        friend request;
+
+        // Operators
+
+        /**
+         * Return header if it exists, otherwise return an empty header
+         */
+        const header_view& operator[](const field key) const;
+
+        /**
+         * Return header (case-insensitive) if it exists, otherwise return an empty header
+         */
+        const header_view& operator[](const std::string_view key) const;
+
+        // Member Functions
+
+        bool               contains(const field key) const;
+
+        bool               contains(const std::string_view key) const;
+
+        void               insert(const std::string_view key, const std::string_view value);
+
+        size_t             size() const;
+    };
+
+    /**
+     * Frames requests as they arrive in pieces, one connection's at a time. The header section is parsed once, and a
+     * chunked body decoded once, however many reads it takes to arrive
+     */
+    class message_framer {
+    public:
+        // Member Functions
+
+        /**
+         * Return the length of the first complete message in buffer, otherwise return 0; throw BAD_REQUEST if it's
+         * malformed, or has conflicting Content-Length values. Until a length is returned, buffer must begin with the
+         * bytes earlier calls were given; after, the next call frames a new message
+         */
+        size_t length(const std::string_view buffer);
+    protected:
+        // Member Fields
+
+        bool          _chunked = false;
+
+        // -1 if absent
+        int           _content_length = -1;
+
+        // Bytes of the chunked body decoded so far
+        size_t        _decoded = 0;
+        chunk_decoder _decoder;
+
+        // Length of the header section, once it's complete
+        size_t        _head = 0;
+
+        // Where the search for the end of the header section resumes
+        size_t        _searched = 0;
+
+        // Member Functions
+
+        /**
+         * Return the length of the chunked body following the header section once it's complete, otherwise return 0;
+         * throw BAD_REQUEST if it's malformed
+         */
+        size_t        _chunked_length(const std::string_view buffer);
+
+        /**
+         * Return true once the header section is complete, setting _head
+         */
+        bool          _find_head(const std::string_view buffer);
+    };
+
     struct request {
         // Constructors
 
-        request(const std::string method, const std::string url, header::map headers = {}, const std::string body = "");
+        /**
+         * Parse message in place; headers and body are views into the message
+         */
+        request(std::string message);
+
+        request(const request& other);
+
+        request(request&& other);
+
+        // Operators
+
+        request&                operator=(const request& other);
+
+        request&                operator=(request&& other);
+
+        // Member Functions
+
+        std::string_view        body() const;
+
+        const header_view::map& headers() const;
+
+        const std::string&      method() const;
+
+        const url::param::map&  params() const;
+
+        const std::string&      url() const;
+    private:
+        // Member Fields
+
+        std::string_view        _body;
+        header_view::map        _headers;
+        std::string             _message;
+        std::string             _method;
+        url::param::map         _params;
+        std::string             _url;
+
+        // Member Functions
+
+        /**
+         * Point views into data at this message instead
+         */
+        void                    _rebase(const char* data);
+    };
 
+    /**
+     * Serializes a response into a buffer reused across responses
+     */
+    struct response_builder {
         // Member Functions
 
-        std::string     body() const;
+        /**
+         * Write Content-Length (unless omitted), end the header section, and write text
+         */
+        response_builder&  body(const std::string_view text, const bool content_length = true);
+
+        /**
+         * Empty the buffer, retaining its capacity
+         */
+        void               clear();
+
+        /**
+         * Write the shared Date header
+         */
+        response_builder&  date();
 
-        header::map     headers();
+        response_builder&  header(const std::string_view key, const std::string_view value);
 
-        std::string     method() const;
+        /**
+         * Write the default headers, less any overridden by headers, followed by headers
+         */
+        response_builder&  headers(const http::header::map& headers);
 
-        url::param::map params();
+        response_builder&  status(const status_code status);
 
-        std::string     url() const;
+        response_builder&  status(const status_code status, const std::string_view status_text);
+
+        const std::string& str() const;
     private:
         // Member Fields
 
-        std::string     _body;
-        header::map     _headers;
-        std::string     _method;
-        url::param::map _params;
-        std::string     _url;
+        std::string        _buffer;
+        status_code        _status = OK;
+    };
+
+    /**
+     * Response serialized once; only its Date header is spliced in, once per second
+     */
+    struct static_response {
+        // Constructors
+
+        static_response();
+
+        static_response(const status_code status, const std::string text, const header::map& headers = {});
+
+        // Member Functions
+
+        /**
+         * Return the shared, serialized response, compressed using coding if worthwhile, current to the second
+         */
+        std::shared_ptr<const std::string> message(const content_coding coding = IDENTITY) const;
+    private:
+        // Member Fields
+
+        size_t                                                    _date_offset = 0;
+
+        // By coding; compressed once, if worthwhile, otherwise NULL
+        mutable std::array<std::shared_ptr<const std::string>, 3> _messages;
     };
 
     // Non-Member Functions
 
-    std::string http_version();
+    /**
+     * Return text framed as a chunk; empty text is the last chunk, followed by an empty trailer section
+     */
+    std::string      chunk(const std::string_view text);
+
+    /**
+     * Return a copy of the current date as an IMF-fixdate, refreshed once per second
+     */
+    fixdate          date();
+
+    /**
+     * Return time as an IMF-fixdate
+     */
+    std::string      date(const time_t time);
+
+    /**
+     * Return headers sent with every response
+     */
+    header::map      default_headers();
+
+    /**
+     * Set headers sent with every response; serialized once
+     */
+    void             default_headers(const header::map headers);
+
+    /**
+     * Return a strong entity tag for body
+     */
+    std::string      etag(const std::string_view body);
+
+    /**
+     * Return the value of header name in serialized message if it exists, otherwise return an empty string
+     */
+    std::string_view find_header(const std::string_view message, const field name);
+
+    std::string      http_version();
+
+    /**
+     * Return the maximum size of a request body, after decoding
+     */
+    size_t           max_body_size();
+
+    /**
+     * Return true if the final transfer coding of value is chunked
+     */
+    bool             is_chunked(const std::string_view value);
+
+    /**
+     * Return the length of the first complete message in buffer, otherwise return 0; see message_framer for messages
+     * that arrive in pieces
+     */
+    size_t           message_length(const std::string_view buffer);
+
+    /**
+     * Return the time an HTTP-date denotes, in IMF-fixdate or either obsolete format, otherwise return -1
+     */
+    time_t           parse_date(const std::string_view value);
+
+    request          parse_request(std::string text);
+
+    /**
+     * Return the method named name (case-insensitive), otherwise return UNKNOWN_METHOD
+     */
+    method_code      parse_method(const std::string_view name);
+
+    std::string      redirect(header::map& headers, const std::string location);
+
+    std::string      redirect(header::map& headers, const status_code status, const std::string location);
 
-    request     parse_request(const std::string text);
+    std::string      response(const std::string text, const header::map& headers);
 
-    std::string redirect(header::map& headers, const std::string location);
+    std::string      response(const status_code status, const std::string status_text, const std::string text, const header::map& headers, const bool date = true);
 
-    std::string redirect(header::map& headers, const status_code status, const std::string location);
+    /**
+     * Return the status line for status, including its terminator, if status is known, otherwise return an empty string
+     */
+    std::string_view status_line(const status_code status);
 
-    std::string response(const std::string text, header::map headers);
+    std::string      strmethod(const method_code method);
 
-    std::string response(const status_code status, const std::string status_text, const std::string text, header::map headers, const bool date = true);
+    std::string      strstatus(const status_code status);
 
-    std::string strstatus(const status_code status);
+    /**
+     * Return a successful GET or HEAD response tagged with a strong ETag, computed over its body unless already tagged,
+     * or a bodiless 304 if the tag matches If-None-Match
+     */
+    std::shared_ptr<const std::string> tag_message(const request& request, const std::shared_ptr<const std::string> message);
 
-    size_t      timeout();
+    size_t           timeout();
 }
 
 #endif /* http_h */
@@ -5,19 +5,49 @@
 //  Created by Corey Ferguson on 1/28/26.
 //
 
+#include "cache.h"
+#include "file_server.h"
+#include "handoff.h"
 #include "http.h"
 #include "json.h"
+#include "lifecycle.h"
 #include "logger.h"
+#include "router.h"
 #include "service.h"
 #include "socket.h"
+#include "task.h"
+#include "thread_pool.h"
 #include "url.h"
-#include <any>
 
 using namespace http;
 using namespace json;
 using namespace mysocket;
 using namespace std;
 
+// Typedef
+
+// A parsed request, or the reply decided while parsing
+struct exchange {
+    // Member Fields
+
+    file_server::reply      reply;
+    optional<class request> request;
+};
+
+// Per-connection state, kept in its context
+struct session {
+    // Member Fields
+
+    // Replies to earlier requests are being prepared; later ones wait
+    bool           busy = false;
+
+    // Progress through the request arriving
+    message_framer framer;
+
+    // Number of requests received
+    size_t         nrequests = 0;
+};
+
 // Non-Member Fields
 
 header::map  _headers = {
@@ -29,13 +59,40 @@ header::map  _headers = {
 
 int          _port = 8080;
 
-atomic<bool> _alive = true;
-mutex        _mutex;
+http::cache  _cache;
+file_server* _files = NULL;
+handoff*     _handoff = NULL;
+lifecycle*   _lifecycle = NULL;
+tcp_server*  _local_server = NULL;
+thread_pool* _pool = NULL;
+router       _router;
 tcp_server*  _server = NULL;
 service      _service;
 
 // Non-Member Functions
 
+// Largest request, with any pipelined behind it, held per connection; connections that exceed it are answered with
+// 413 or 431 and closed
+size_t buffer_capacity() {
+    return 1 << 20;
+}
+
+// Seconds a server stopping, or that handed off its listeners, lets in-flight requests finish
+size_t drain_timeout() {
+    return 30;
+}
+
+// Take the listeners of a server already running from this Unix-domain socket, and later hand them to the next, so
+// that restarts refuse no connections; "@name" is abstract (Linux). Empty to disable
+string handoff_socket() {
+    return "";
+}
+
+// Falls back to epoll or kqueue where unsupported
+bool io_uring() {
+    return true;
+}
+
 // HTTP/1.1 default
 size_t keep_alive_timeout() {
     return 5;
@@ -46,131 +103,561 @@ int keep_alive_max() {
     return 200;
 }
 
-any sync(std::function<any(void)> cb) {
-    _mutex.lock();
-    
-    any result = cb();
-    
-    _mutex.unlock();
-    
-    return result;
+// Request batches queued before new ones are answered 503
+size_t pool_capacity() {
+    return 1024;
+}
+
+// Request-handling threads
+size_t pool_size() {
+    return max(thread::hardware_concurrency(), 1u);
+}
+
+// One listener per event loop, on Linux; connections needn't queue behind one accept loop
+bool reuse_port() {
+    return true;
+}
+
+// Directory served under static_path()
+string static_directory() {
+    return "public";
+}
+
+string static_path() {
+    return "/static/";
+}
+
+// Also serve on this Unix-domain socket, for proxies on the same host; "@name" is abstract (Linux). Empty to disable
+string unix_socket() {
+    return "";
+}
+
+const set<string>& allow_methods() {
+    static const set<string> methods = { "GET", "HEAD", "PUT", "PATCH", "POST", "DELETE" };
+
+    return methods;
 }
 
-set<string> allow_methods() {
-    return { "GET", "HEAD", "PUT", "PATCH", "POST", "DELETE" };
+void log_request(const class request& request) {
+    logger::info("url: " + request.url() + ", body: " + (request.body().empty() ? null() : string(request.body())));
 }
 
-header::map headers() {
-    return any_cast<header::map>(sync([]() {
-        return _headers;
+shared_ptr<const string> handle_request(const class request& request) {
+    router::match match = _router.find(parse_method(request.method()), request.url());
+
+    if (match.handler)
+        return compress_message(tag_message(request, (* match.handler)(request, match.params)), negotiate_coding(request.headers()[field::ACCEPT_ENCODING]));
+
+    return make_shared<const string>(response(NOT_FOUND, strstatus(NOT_FOUND), "Cannot " + toupperstr(request.method()) + " " + request.url(), {
+        { "Content-Type", string("text/plain; charset=utf-8") }
     }));
 }
 
-void log_request(class request request) {
-    logger::info("url: " + request.url() + ", body: " + (request.body().empty() ? null() : request.body()));
+// As above, for requests routed to coroutines; on the connection's loop
+task<shared_ptr<const string>> handle_request(const class request& request, const router::match match) {
+    shared_ptr<const string> message = co_await (* match.coroutine)(request, match.params);
+
+    co_return compress_message(tag_message(request, message), negotiate_coding(request.headers()[field::ACCEPT_ENCODING]));
 }
 
-string handle_request(header::map headers, class request request) {
-    auto options = [](header::map headers) {
-        headers["Access-Control-Allow-Methods"] = allow_methods();
+// Return true if request is answered by a coroutine on its connection's loop, rather than on the pool
+bool is_coroutine(const class request& request) {
+    string method = toupperstr(request.method());
 
-        return response(NO_CONTENT, strstatus(NO_CONTENT), "", headers);
-    };
-    
-    auto not_found = [request, &headers]() {
-        headers["Content-Type"] = string("text/plain; charset=utf-8");
-        
-        return response(NOT_FOUND, strstatus(NOT_FOUND), "Cannot " + toupperstr(request.method()) + " " + request.url(), headers);
+    if ((method == "GET" || method == "HEAD") && request.url().starts_with(static_path()))
+        return false;
+
+    router::match match = _router.find(parse_method(request.method()), request.url());
+
+    return match.coroutine || match.stream;
+}
+
+// Return a handler that sends response from its shared buffer
+router::handler static_route(const static_response response) {
+    return [response](const class request& request, const router::params&) {
+        return response.message(negotiate_coding(request.headers()[field::ACCEPT_ENCODING]));
     };
-    
-    string url = request.url(),
-            url_prefix = "/api";
-    
-    if (starts_with(url, url_prefix)) {
-        url = url.substr(url_prefix.length());
-        
-        if (url == "/greeting") {
-            if (request.method() == "options") {
-                headers["Accept"] = string("application/json");
-
-                return options(headers);
-            }
-            
-            auto greeting = [request, headers]() {
+}
+
+void initialize() {
+    // Preserve comma-separated header values' order
+    vector<string> ka = { join({ "timeout", to_string(keep_alive_timeout()) }, "=") };
+
+    if (keep_alive_max() > 0)
+        ka.push_back(join({ "max", to_string(keep_alive_max()) }, "="));
+
+    _headers["Keep-Alive"] = join(ka, ",");
+
+    default_headers(_headers);
+
+    _files = new file_server(static_directory());
+    _pool = new thread_pool(pool_size(), pool_capacity());
+
+    static_response no_content(NO_CONTENT, ""),
+                    ping = _service.ping();
+
+    _router.add(GET, "/api/ping", [ping](const class request& request, const router::params&) {
 #if LOGGING
-                log_request(request);
+        log_request(request);
 #endif
 
-                return _service.greeting(headers, request);
-            };
-            
-            if (request.method() == "head") {
-                greeting();
-                
-                return response(NO_CONTENT, strstatus(NO_CONTENT), "", headers);
-            }
+        return ping.message();
+    });
 
-            if (request.method() == "post")
-                return greeting();
+    _router.add(HEAD, "/api/ping", [no_content](const class request& request, const router::params&) {
+#if LOGGING
+        log_request(request);
+#endif
 
-            return not_found();
-        }
-        
-        if (url == "/ping") {
-            if (request.method() == "options")
-                return options(headers);
-            
-            auto ping = [request, headers]() {
+        return no_content.message();
+    });
+
+    _router.add(POST, "/api/greeting", [](const class request& request, const router::params&) -> task<shared_ptr<const string>> {
 #if LOGGING
-                log_request(request);
+        log_request(request);
 #endif
-                
-                return _service.ping(headers);
-            };
-            
-            if (request.method() == "head") {
-                ping();
-                
-                return response(NO_CONTENT, strstatus(NO_CONTENT), "", headers);
+
+        co_return make_shared<const string>(co_await _service.greeting(request));
+    });
+
+    // Repeated greetings are served from memory, for a second
+    cache::policy greetings;
+
+    greetings.max_bytes = 1 << 20;
+    greetings.ttl = chrono::seconds(1);
+
+    _router.add(GET, "/api/greeting", _cache.route(greetings, [](const class request& request, const router::params&) {
+#if LOGGING
+        log_request(request);
+#endif
+
+        return make_shared<const string>(_service.greeting({}, request.params()));
+    }));
+
+    _router.add(HEAD, "/api/greeting", [no_content](const class request& request, const router::params&) {
+#if LOGGING
+        log_request(request);
+#endif
+
+        _service.greeting({}, request);
+
+        return no_content.message();
+    });
+
+    // CORS preflight
+    header::map options = {
+        { "Access-Control-Allow-Methods", allow_methods() }
+    };
+
+    _router.add(OPTIONS, "/api/ping", static_route(static_response(NO_CONTENT, "", options)));
+
+    options["Accept"] = string("application/json");
+
+    _router.add(OPTIONS, "/api/greeting", static_route(static_response(NO_CONTENT, "", options)));
+}
+
+void handle_connection(tcp_server::connection* connection);
+
+// Return message saying Connection: close instead of keep-alive, so that clients don't reuse the connection
+shared_ptr<const string> closing_message(const shared_ptr<const string> message) {
+    size_t end = message->find("\r\n\r\n"),
+           start = message->find("Connection: keep-alive\r\n");
+
+    if (start > end)
+        return message;
+
+    string result = * message;
+
+    result.replace(start, strlen("Connection: keep-alive"), "Connection: close");
+
+    return make_shared<const string>(std::move(result));
+}
+
+// Queue exchange's reply; closing if it's the last before the connection closes
+void queue_reply(tcp_server::connection* connection, const struct exchange& exchange, const bool closing) {
+#if LOGGING == LEVEL_DEBUG
+    cout << * exchange.reply.message << endl;
+#endif
+
+    if (closing)
+        connection->queue(closing_message(exchange.reply.message));
+    else
+        connection->queue(exchange.reply.message);
+
+    // Sent from the page cache, after the replies preceding it
+    if (exchange.reply.file)
+        connection->queue(exchange.reply.file->file_descriptor, exchange.reply.offset, exchange.reply.length, exchange.reply.file);
+}
+
+// Send replies in request order, then parse requests that arrived meanwhile; on the connection's loop
+void respond(tcp_server::connection* connection, const vector<struct exchange>& exchanges, const bool close) {
+    static_pointer_cast<struct session>(connection->context())->busy = false;
+
+    for (const struct exchange& exchange: exchanges)
+        queue_reply(connection, exchange, close && &exchange == &exchanges.back());
+
+    connection->flush();
+
+    // Sends what's queued first
+    if (close)
+        return connection->close();
+
+    // Keep alive
+    connection->timeout(chrono::seconds(keep_alive_timeout()));
+
+    handle_connection(connection);
+}
+
+// Send text as part of a streamed response once the connection has room for it; false if it closed. On the
+// connection's loop
+task<bool> send_streamed(tcp_server::connection* connection, const weak_ptr<bool> lifetime, const shared_ptr<const string> text) {
+    // Released while the handler awaited something else
+    if (lifetime.expired())
+        co_return false;
+
+    // Closed if the peer stops reading
+    connection->timeout(chrono::seconds(http::timeout()));
+
+    bool sent = co_await connection->write(text);
+
+    if (sent)
+        connection->timeout(chrono::milliseconds::max());
+
+    co_return sent;
+}
+
+// Run a stream handler, sending its response after those queued as it's produced; closing if it's the last before
+// the connection closes. Return false if it was cut short, so that the connection must close; throw if the handler
+// fails before sending anything. On the connection's loop
+task<bool> handle_stream(tcp_server::connection* connection, const class request& request, const router::match match, const bool closing) {
+    weak_ptr<bool>   lifetime = connection->lifetime();
+    shared_ptr<bool> started = make_shared<bool>(false);
+    chunked_writer   writer([connection, lifetime, started, closing](const string_view text) {
+        shared_ptr<const string> message = make_shared<const string>(text);
+
+        // The head
+        if (!* started && closing)
+            message = closing_message(message);
+
+        * started = true;
+
+        return send_streamed(connection, lifetime, message);
+    });
+
+    try {
+        co_await (* match.stream)(request, match.params, writer);
+    } catch (std::exception& e) {
+        if (!* started)
+            throw;
+
+        // Too late to answer otherwise; the client sees the body cut short
+        logger::error(e.what());
+
+        co_return false;
+    }
+
+    if (!* started)
+        throw runtime_error("Cannot " + toupperstr(request.method()) + " " + request.url() + ": nothing was sent");
+
+    co_return co_await writer.end();
+}
+
+// Answer requests routed to coroutines on the connection's loop; they suspend without holding a thread
+task<void> handle_coroutines(tcp_server::connection* connection, const shared_ptr<vector<struct exchange>> exchanges, const bool close) {
+    function<void(const function<void()>)> resume = connection->hold();
+    weak_ptr<bool>                         lifetime = connection->lifetime();
+    bool                                   closing = close;
+
+    // Replies queued already, ahead of a streamed one
+    size_t                                 sent = 0;
+
+    for (size_t i = 0; i < exchanges->size(); i++) {
+        struct exchange& exchange = (* exchanges)[i];
+
+        if (!exchange.request)
+            continue;
+
+        const class request& request = * exchange.request;
+        router::match        match = _router.find(parse_method(request.method()), request.url());
+
+        try {
+            if (match.stream) {
+                // Released while an earlier coroutine suspended
+                if (lifetime.expired())
+                    break;
+
+                for (; sent < i; sent++)
+                    queue_reply(connection, (* exchanges)[sent], false);
+
+                bool streamed = co_await handle_stream(connection, request, match, closing && i + 1 == exchanges->size());
+
+                sent = i + 1;
+
+                if (!streamed) {
+                    exchanges->resize(i + 1);
+
+                    closing = true;
+                }
+
+                continue;
             }
 
-            if (request.method() == "get")
-                return ping();
+            exchange.reply.message = co_await handle_request(request, match);
+        } catch (http::error& e) {
+            exchange.reply.message = make_shared<const string>(response(BAD_REQUEST, strstatus(BAD_REQUEST), e.text(), {
+                { "Connection", "close" }
+            }, false));
+
+            // Later requests go unanswered
+            exchanges->resize(i + 1);
+
+            closing = true;
+        } catch (std::exception& e) {
+            // A handler failed; answer rather than leave the connection waiting
+            logger::error(e.what());
+
+            exchange.reply.message = make_shared<const string>(response(INTERNAL_SERVER_ERROR, strstatus(INTERNAL_SERVER_ERROR), "", {
+                { "Connection", "close" }
+            }, false));
+
+            exchanges->resize(i + 1);
 
-            return not_found();
+            closing = true;
         }
-        
-        return not_found();
     }
 
-    return not_found();
+    exchanges->erase(exchanges->begin(), exchanges->begin() + min(sent, exchanges->size()));
+
+    // The connection may have closed meanwhile
+    resume([connection, exchanges, closing]() {
+        respond(connection, * exchanges, closing);
+    });
 }
 
-void initialize() {
-    // Preserve comma-separated header values' order
-    vector<string> ka = { join({ "timeout", to_string(keep_alive_timeout()) }, "=") };
+// Parse buffered requests and hand them to the pool, or to coroutines; replies are sent from the connection's loop
+void handle_connection(tcp_server::connection* connection) {
+    struct session& session = * static_pointer_cast<struct session>(connection->context());
+
+    if (session.busy)
+        return;
+
+    // Bytes received but not yet parsed; may hold several pipelined requests
+    string_view                        buffer = connection->buffer();
+    shared_ptr<vector<struct exchange>> exchanges = make_shared<vector<struct exchange>>();
+    size_t                             start = 0;
+    bool                               close = false,
+                                       coroutines = false,
+                                       pending = false;
+
+    // Reply without involving the pool
+    auto handle_response = [&exchanges](shared_ptr<const string> response) {
+        exchanges->emplace_back();
+        exchanges->back().reply.message = response;
+    };
 
-    if (keep_alive_max() > 0)
-        ka.push_back(join({ "max", to_string(keep_alive_max()) }, "="));
+    try {
+        while (!close) {
+            // Ignore empty lines preceding a request
+            while (start < buffer.length() && (buffer[start] == '\r' || buffer[start] == '\n'))
+                start++;
 
-    _headers["Keep-Alive"] = join(ka, ",");
-}
+            size_t length = session.framer.length(buffer.substr(start));
+
+            if (!length)
+                break;
+
+            class request request_obj = parse_request(string(buffer.substr(start, length)));
+            bool          coroutine = is_coroutine(request_obj);
+
+            // Batches go wholly to the pool or to coroutines; the rest waits for their replies
+            if (pending && coroutine != coroutines)
+                break;
+
+            start += length;
+            session.nrequests++;
+
+            if (request_obj.headers()[field::HOST].empty()) {
+                handle_response(make_shared<const string>(response(BAD_REQUEST, strstatus(BAD_REQUEST), "", {
+                    { "Connection", "close" },
+                    { "Transfer-Encoding", string("chunked") }
+                })));
 
-// Perform garbage collection
-void onsignal(int signum) {
-    thread([]() {
-        cout << endl;
-        cout << "Stop? (y/N) ";
+                close = true;
 
-        string str;
+                break;
+            }
+
+            string method = toupperstr(request_obj.method());
+
+            if (method != "OPTIONS" && allow_methods().find(method) == allow_methods().end())
+                throw http::error(BAD_REQUEST);
+
+            exchanges->emplace_back();
+            exchanges->back().request = std::move(request_obj);
 
-        getline(cin, str);
+            coroutines = coroutine;
+            pending = true;
 
-        if (tolowerstr(str) == "y") {
-            _server->close();
-            _alive.store(false);
+            // Below 0, unlimited
+            if (keep_alive_max() >= 0 && session.nrequests >= static_cast<size_t>(keep_alive_max()))
+                close = true;
         }
-    }).detach();
+    } catch (http::error& e) {
+        handle_response(make_shared<const string>(response(BAD_REQUEST, strstatus(BAD_REQUEST), e.text(), {
+            { "Connection", "close" }
+        }, false)));
+
+        close = true;
+    }
+
+    connection->consume(start);
+
+    if (exchanges->empty())
+        return;
+
+    if (!pending)
+        return respond(connection, * exchanges, close);
+
+    session.busy = true;
+
+    // Not idle while handling; respond() restarts the keep-alive timeout
+    connection->timeout(chrono::milliseconds::max());
+
+    if (coroutines)
+        return handle_coroutines(connection, exchanges, close).detach();
+
+    function<void(const function<void()>)> resume = connection->hold();
+
+    bool queued = _pool->submit([connection, exchanges, close, resume]() {
+        bool closing = close;
+
+        for (size_t i = 0; i < exchanges->size(); i++) {
+            struct exchange& exchange = (* exchanges)[i];
+
+            if (!exchange.request)
+                continue;
+
+            const class request& request = * exchange.request;
+
+            try {
+                string method = toupperstr(request.method());
+
+                if ((method == "GET" || method == "HEAD") && request.url().starts_with(static_path()))
+                    exchange.reply = _files->serve(request, string_view(request.url()).substr(static_path().length()));
+                else
+                    exchange.reply.message = handle_request(request);
+            } catch (http::error& e) {
+                exchange.reply.message = make_shared<const string>(response(BAD_REQUEST, strstatus(BAD_REQUEST), e.text(), {
+                    { "Connection", "close" }
+                }, false));
+
+                // Later requests go unanswered
+                exchanges->resize(i + 1);
+
+                closing = true;
+            } catch (std::exception& e) {
+                // A handler failed; answer rather than leave the connection waiting
+                logger::error(e.what());
+
+                exchange.reply.message = make_shared<const string>(response(INTERNAL_SERVER_ERROR, strstatus(INTERNAL_SERVER_ERROR), "", {
+                    { "Connection", "close" }
+                }, false));
+
+                exchanges->resize(i + 1);
+
+                closing = true;
+            }
+        }
+
+        resume([connection, exchanges, closing]() {
+            respond(connection, * exchanges, closing);
+        });
+    });
+
+    if (queued)
+        return;
+
+    // Overloaded; shed this batch rather than queue without bound
+    for (struct exchange& exchange: * exchanges)
+        if (exchange.request)
+            exchange.reply.message = make_shared<const string>(response(SERVICE_UNAVAILABLE, strstatus(SERVICE_UNAVAILABLE), "", {
+                { "Retry-After", string("1") }
+            }));
+
+    resume([connection, exchanges, close]() {
+        respond(connection, * exchanges, close);
+    });
+}
+
+// Called on the connection's event loop when a request outgrows buffer_capacity(), before the connection closes
+void handle_overflow(tcp_server::connection* connection) {
+    // Replies to earlier requests are still being prepared; one now would overtake them
+    if (!connection->context() || static_pointer_cast<struct session>(connection->context())->busy)
+        return;
+
+    string_view buffer = connection->buffer();
+
+    // A complete head means the body is too large
+    status_code status = buffer.find("\n\n") != string_view::npos || buffer.find("\n\r\n") != string_view::npos ? CONTENT_TOO_LARGE : REQUEST_HEADER_FIELDS_TOO_LARGE;
+
+    connection->queue(make_shared<const string>(response(status, strstatus(status), "", {
+        { "Connection", "close" }
+    })));
+}
+
+// Drop cached responses and files, so that changes are served (SIGHUP)
+void reload() {
+    _cache.clear();
+    _files->clear();
+
+    logger::info("reloaded");
+}
+
+// Let in-flight requests finish, up to drain_timeout(), and stop; handed_off if a successor serves the listeners now
+void shut_down(const bool handed_off) {
+    static bool stopping = false;
+
+    // A signal may follow the handoff
+    if (stopping)
+        return;
+
+    stopping = true;
+
+    if (_handoff) {
+        _handoff->close();
+
+        _handoff = NULL;
+    }
+
+    size_t remaining = _server->drain(chrono::seconds(drain_timeout()));
+
+    if (_local_server)
+        remaining += _local_server->drain(chrono::seconds(drain_timeout()));
+
+    logger::info(string(handed_off ? "handed off: " : "stopping: ") + to_string(remaining) + " connections cut at the deadline");
+
+    struct cache::stats stats = _cache.stats();
+
+    logger::info("cache: " + to_string(stats.hits) + " hits, " + to_string(stats.misses) + " misses, " + to_string(stats.entries) + " entries");
+
+    struct thread_pool::stats pool_stats = _pool->stats();
+
+    logger::info("pool: " + to_string(pool_stats.executed) + " executed, " + to_string(pool_stats.steals) + " stolen, " + to_string(pool_stats.rejected) + " rejected, " + to_string(pool_stats.depth) + " queued");
+
+    // Finish replies before their connections close
+    delete _pool;
+
+    _server->close();
+
+    if (_local_server) {
+        _local_server->close();
+
+        // Draining left the path in place for a successor
+        if (!handed_off && unix_socket()[0] != '@')
+            unlink(unix_socket().c_str());
+    }
+
+    _lifecycle->stop();
 }
 
 int main(int argc, const char* argv[]) {
@@ -181,128 +668,94 @@ int main(int argc, const char* argv[]) {
             _port = 3000;
     }
 
+    // Before any thread starts, so that none takes the signals
+    _lifecycle = new lifecycle({
+        { SIGHUP, reload },
+        { SIGINT, []() {
+            shut_down(false);
+        } },
+        { SIGTERM, []() {
+            shut_down(false);
+        } }
+    });
+
     initialize();
 
-    while (true) {
-        try {
-            _server = new tcp_server(_port, [](tcp_server::connection* connection) {
-                // Number of requests received
-                atomic<size_t> nrequests = 0;
-                
-                // Handle request in its own thread
-                thread([&nrequests, connection]() {
-                    // Set connection timeout
-                    thread([&nrequests, connection]() {
-                        for (size_t i = 0; i < http::timeout() && !nrequests.load(); i++)
-                            this_thread::sleep_for(chrono::milliseconds(1000));
-
-                        if (nrequests.load())
-                            return;
-
-                        nrequests.store(1);
-                        connection->close();
-                    }).detach();
-
-                    // Wait for non-empty request
-                    while (true) {
-                        try {
-                            string request = connection->recv();
-
-                            if (request.empty())
-                                continue;
-
-                            nrequests.fetch_add(1);
-
-                            auto handle_response = [connection](const string response) {
-#if LOGGING == LEVEL_DEBUG
-                                cout << response << endl;
-#endif
+    struct tcp_server::options options;
 
-                                connection->send(response);
-                            };
-
-                            try {
-                                class request request_obj = parse_request(request);
-
-                                if (request_obj.headers()["host"].str().length()) {
-                                    auto next = [&]() {
-                                        string response = handle_request(headers(), request_obj);
-
-                                        handle_response(response);
-
-                                        size_t nrequest = nrequests.load();
-
-                                        if (nrequest >= keep_alive_max()) {
-                                            connection->close();
-                                            
-                                            return true;
-                                        }
-
-                                        // Keep alive
-                                        thread([nrequest, &nrequests, connection]() {
-                                            for (int i = 0; i < keep_alive_timeout() && nrequest == nrequests.load(); i++)
-                                                this_thread::sleep_for(chrono::milliseconds(1000));
-
-                                            if (nrequest == nrequests.load())
-                                                connection->close();
-                                        }).detach();
-                                        
-                                        return false;
-                                    };
-
-                                    string method = toupperstr(request_obj.method());
-                                    
-                                    if (method == "OPTIONS") {
-                                        if (next())
-                                            return;
-                                    } else {
-                                        if (allow_methods().find(method) == allow_methods().end())
-                                            throw http::error(BAD_REQUEST);
-                                            
-                                        if (next())
-                                            return;
-                                    }
-                                } else {
-                                    handle_response(response(BAD_REQUEST, strstatus(BAD_REQUEST), to_string(0), {
-                                        { "Connection", "close" },
-                                        { "Transfer-Encoding", "chunked "}
-                                    }));
-
-                                    return connection->close();
-                                }
-                            } catch (http::error& e) {
-                                handle_response(response(BAD_REQUEST, strstatus(BAD_REQUEST), e.text(), {
-                                    { "Connection", "close" }
-                                }, false));
-                        
-                                return connection->close();
-                            }
-                        } catch (mysocket::error& e) {
-                            // Connection timed out; suppress error
-                            if (nrequests.load())
-                                return;
-
-                            throw e;
-                        }
-                    }
-                }).detach();
-            });
-            
-            signal(SIGINT, onsignal);
-            signal(SIGTERM, onsignal);
+    // Close connections that send no request in time
+    options.timeout = chrono::seconds(http::timeout());
+    options.buffer_capacity = buffer_capacity();
+    options.io_uring = io_uring();
+    options.overflow = handle_overflow;
+    options.reuse_port = reuse_port();
 
-            cout << "Server listening on port " << _port << "...\n";
+    // Called on the connection's event loop each time bytes arrive
+    auto handler = [](tcp_server::connection* connection) {
+        if (!connection->context())
+            connection->context() = make_shared<struct session>();
 
-            while (_alive.load())
-                continue;
+        handle_connection(connection);
+    };
+
+    if (handoff_socket().length()) {
+        _handoff = new handoff(handoff_socket());
+
+        // The TCP listeners, then any Unix-domain ones
+        vector<vector<int>> listeners = _handoff->receive();
+
+        if (listeners.size()) {
+            _server = new tcp_server(listeners[0], handler, options);
+
+            if (listeners.size() > 1 && listeners[1].size()) {
+                if (unix_socket().length())
+                    _local_server = new tcp_server(listeners[1], handler, options);
+                else
+                    for (int listener: listeners[1])
+                        close(listener);
+            }
+
+            // Serving; the predecessor may drain
+            _handoff->acknowledge();
 
-            break;
+            cout << "Server resumed on handed-off listeners...\n";
+        }
+    }
+
+    if (unix_socket().length() && !_local_server) {
+        _local_server = new tcp_server(unix_socket(), handler, options);
+
+        cout << "Server listening on " << unix_socket() << "...\n";
+    }
+
+    while (!_server) {
+        try {
+            _server = new tcp_server(_port, handler, options);
+
+            cout << "Server listening on port " << _port << "...\n";
         } catch (mysocket::error& e) {
-            // EADDRINUSE
-            if (e.errnum() == 48)
+            if (e.errnum() == EADDRINUSE)
                 _port++;
             else
                 throw e;
         }
     }
+
+    // Writes to closed connections fail with EPIPE instead
+    signal(SIGPIPE, SIG_IGN);
+
+    if (_handoff)
+        _handoff->offer([]() {
+            return vector<vector<int>> { _server->listeners(), _local_server ? _local_server->listeners() : vector<int> { } };
+        }, []() {
+            // The successor accepts now; finish what's in flight
+            _lifecycle->post([]() {
+                shut_down(true);
+            });
+        });
+
+    // Sleeps until signaled
+    _lifecycle->run();
+
+    delete _lifecycle;
 }
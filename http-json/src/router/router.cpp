@@ -0,0 +1,305 @@
+//
+//  router.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "router.h"
+
+namespace http {
+    // Constructors
+
+    chunked_writer::chunked_writer(const sink sink, const size_t capacity) {
+        this->_sink = sink;
+        this->_capacity = capacity;
+    }
+
+    router::error::error(const std::string what) {
+        this->_what = what;
+    }
+
+    router::router() {
+        this->_root = new node();
+    }
+
+    router::~router() {
+        delete this->_root;
+    }
+
+    router::node::~node() {
+        for (node* child: this->children)
+            delete child;
+
+        delete this->param;
+    }
+
+    // Operators
+
+    std::string_view router::params::operator[](const std::string_view name) const {
+        for (size_t i = 0; i < this->size(); i++)
+            if (this->_values[i].first == name)
+                return this->_values[i].second;
+
+        return "";
+    }
+
+    // Member Functions
+
+    const router::node* router::_find(const node* node, const method_code method, const std::string_view path, class params& params) const {
+        if (path.empty())
+            return node->handlers[method] || node->coroutines[method] || node->streams[method] ? node : NULL;
+
+        // Static text takes precedence over parameters
+        for (const struct node* child: node->children) {
+            if (child->prefix[0] != path[0])
+                continue;
+
+            if (path.substr(0, child->prefix.length()) == child->prefix) {
+                const struct node* result = this->_find(child, method, path.substr(child->prefix.length()), params);
+
+                if (result)
+                    return result;
+            }
+
+            break;
+        }
+
+        if (node->param == NULL)
+            return NULL;
+
+        size_t end = path.find('/');
+
+        if (end == std::string_view::npos)
+            end = path.length();
+
+        // Parameters are non-empty
+        if (end == 0)
+            return NULL;
+
+        size_t size = params._size;
+
+        params._values[params._size++] = { node->param->name, path.substr(0, end) };
+
+        const struct node* result = this->_find(node->param, method, path.substr(end), params);
+
+        // Backtrack
+        if (result == NULL)
+            params._size = size;
+
+        return result;
+    }
+
+    void router::add(const method_code method, const std::string path, const handler handler) {
+        node* node = this->_insert(method, path);
+
+        node->coroutines[method] = nullptr;
+        node->handlers[method] = handler;
+        node->streams[method] = nullptr;
+    }
+
+    void router::add(const method_code method, const std::string path, const coroutine coroutine) {
+        node* node = this->_insert(method, path);
+
+        node->coroutines[method] = coroutine;
+        node->handlers[method] = nullptr;
+        node->streams[method] = nullptr;
+    }
+
+    void router::add(const method_code method, const std::string path, const stream stream) {
+        node* node = this->_insert(method, path);
+
+        node->coroutines[method] = nullptr;
+        node->handlers[method] = nullptr;
+        node->streams[method] = stream;
+    }
+
+    size_t router::params::capacity() {
+        return std::tuple_size<decltype(params::_values)>::value;
+    }
+
+    mysocket::task<bool> chunked_writer::end() {
+        // Awaited apart from the condition; some compilers mishandle it there
+        bool flushed = co_await this->flush();
+
+        if (!flushed)
+            co_return false;
+
+        co_return co_await this->_sink(chunk(""));
+    }
+
+    router::match router::find(const method_code method, const std::string_view path) const {
+        match result;
+
+        if (method == UNKNOWN_METHOD)
+            return result;
+
+        const node* node = this->_find(this->_root, method, path, result.params);
+
+        if (node == NULL)
+            return result;
+
+        if (node->coroutines[method])
+            result.coroutine = &node->coroutines[method];
+        else if (node->streams[method])
+            result.stream = &node->streams[method];
+        else
+            result.handler = &node->handlers[method];
+
+        return result;
+    }
+
+    mysocket::task<bool> chunked_writer::flush() {
+        if (this->_buffer.empty())
+            co_return true;
+
+        std::string text = chunk(this->_buffer);
+
+        this->_buffer.clear();
+
+        co_return co_await this->_sink(text);
+    }
+
+    mysocket::task<bool> chunked_writer::head(const status_code status, const header::map& headers) {
+        header::map      values = headers;
+        response_builder builder;
+
+        values["Transfer-Encoding"] = std::string("chunked");
+
+        builder.status(status);
+        builder.date();
+        builder.headers(values);
+        builder.body("", false);
+
+        co_return co_await this->_sink(builder.str());
+    }
+
+    router::node* router::_insert(const method_code method, const std::string path) {
+        if (method == UNKNOWN_METHOD)
+            throw router::error("Unknown method");
+
+        if (path.empty() || path[0] != '/')
+            throw router::error("Path must begin with /");
+
+        node*  node = this->_root;
+        size_t nparams = 0,
+               start = 0;
+
+        while (start < path.length()) {
+            if (path[start] == ':') {
+                size_t end = path.find('/', start);
+
+                if (end == std::string::npos)
+                    end = path.length();
+
+                std::string name = path.substr(start + 1, end - start - 1);
+
+                if (name.empty())
+                    throw router::error("Unnamed parameter: " + path);
+
+                if (++nparams > params::capacity())
+                    throw router::error("Too many parameters: " + path);
+
+                if (node->param == NULL) {
+                    node->param = new struct node();
+                    node->param->name = name;
+                } else if (node->param->name != name)
+                    throw router::error("Conflicting parameter names: " + node->param->name + ", " + name);
+
+                node = node->param;
+                start = end;
+
+                continue;
+            }
+
+            size_t end = path.find(':', start);
+
+            if (end == std::string::npos)
+                end = path.length();
+
+            std::string_view text = std::string_view(path).substr(start, end - start);
+
+            while (text.length()) {
+                struct node* child = NULL;
+
+                for (struct node* value: node->children)
+                    if (value->prefix[0] == text[0]) {
+                        child = value;
+
+                        break;
+                    }
+
+                if (child == NULL) {
+                    child = new struct node();
+                    child->prefix = text;
+
+                    node->children.push_back(child);
+
+                    node = child;
+
+                    break;
+                }
+
+                size_t common = 0;
+
+                while (common < child->prefix.length() && common < text.length() && child->prefix[common] == text[common])
+                    common++;
+
+                // Split child at the common prefix
+                if (common < child->prefix.length()) {
+                    struct node* suffix = new struct node();
+
+                    suffix->prefix = child->prefix.substr(common);
+                    suffix->children = std::move(child->children);
+                    suffix->coroutines = std::move(child->coroutines);
+                    suffix->handlers = std::move(child->handlers);
+                    suffix->param = child->param;
+                    suffix->streams = std::move(child->streams);
+
+                    child->prefix.resize(common);
+                    child->children = { suffix };
+                    child->coroutines = {};
+                    child->handlers = {};
+                    child->param = NULL;
+                    child->streams = {};
+                }
+
+                node = child;
+                text.remove_prefix(common);
+            }
+
+            start = end;
+        }
+
+        return node;
+    }
+
+    size_t router::params::size() const {
+        return this->_size;
+    }
+
+    const char* router::error::what() const throw() {
+        return this->_what.c_str();
+    }
+
+    mysocket::task<bool> chunked_writer::write(const std::string_view text) {
+        if (this->_buffer.length() + text.length() < this->_capacity) {
+            this->_buffer += text;
+
+            co_return true;
+        }
+
+        bool flushed = co_await this->flush();
+
+        if (!flushed)
+            co_return false;
+
+        // Send large writes without buffering
+        if (text.length() >= this->_capacity)
+            co_return co_await this->_sink(chunk(text));
+
+        this->_buffer += text;
+
+        co_return true;
+    }
+}
@@ -0,0 +1,201 @@
+//
+//  router.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef router_h
+#define router_h
+
+#include "http.h"
+#include "task.h"
+
+namespace http {
+    /**
+     * Streams a response to sink using the chunked transfer coding. Each call completes once sink has taken what it
+     * sends, so output can't outpace the peer, and returns false if the peer went away
+     */
+    struct chunked_writer {
+        // Typedef
+
+        /**
+         * Send text, which is valid only until it suspends; return false if it can't be sent
+         */
+        using sink = std::function<mysocket::task<bool>(const std::string_view text)>;
+
+        // Constructors
+
+        chunked_writer(const sink sink, const size_t capacity = 16384);
+
+        // Member Functions
+
+        /**
+         * Send buffered output and the last chunk
+         */
+        mysocket::task<bool> end();
+
+        /**
+         * Send buffered output as a chunk
+         */
+        mysocket::task<bool> flush();
+
+        /**
+         * Send the status line and headers
+         */
+        mysocket::task<bool> head(const status_code status, const header::map& headers = {});
+
+        /**
+         * Buffer text, sending a chunk whenever capacity is reached; text must stay valid until this completes
+         */
+        mysocket::task<bool> write(const std::string_view text);
+    private:
+        // Member Fields
+
+        std::string _buffer;
+        size_t      _capacity;
+        sink        _sink;
+    };
+
+    /**
+     * Radix tree of routes; paths may have parameters, e.g., /api/users/:id
+     */
+    struct router {
+        // Typedef
+
+        struct error: public std::exception {
+            // Constructors
+
+            error(const std::string what);
+
+            // Member Fields
+
+            const char* what() const throw();
+        private:
+            // Member Fields
+
+            std::string _what;
+        };
+
+        /**
+         * Path parameters; views into the route and the request URL
+         */
+        class params {
+            // Member Fields
+
+            size_t                                                         _size = 0;
+            std::array<std::pair<std::string_view, std::string_view>, 8> _values;
+        public:
+            // Typedef
+
+            friend router;
+
+            // Operators
+
+            /**
+             * Return the value of parameter name if it exists, otherwise return an empty string
+             */
+            std::string_view operator[](const std::string_view name) const;
+
+            // Member Functions
+
+            /**
+             * Return the maximum number of parameters in a path
+             */
+            static size_t    capacity();
+
+            size_t           size() const;
+        };
+
+        /**
+         * Handler that may suspend, e.g. on upstream I/O, without blocking a thread
+         */
+        using coroutine = std::function<mysocket::task<std::shared_ptr<const std::string>>(const request& request, const params& params)>;
+
+        using handler = std::function<std::shared_ptr<const std::string>(const request& request, const params& params)>;
+
+        /**
+         * Coroutine that sends its response through writer as it's produced, rather than returning it whole
+         */
+        using stream = std::function<mysocket::task<void>(const request& request, const params& params, chunked_writer& writer)>;
+
+        /**
+         * At most one of handler, coroutine, and stream is set
+         */
+        struct match {
+            // Member Fields
+
+            const router::coroutine* coroutine = NULL;
+            const router::handler*   handler = NULL;
+            class params             params;
+            const router::stream*    stream = NULL;
+        };
+
+        // Constructors
+
+        router();
+
+        router(const router& other) = delete;
+
+        ~router();
+
+        // Member Functions
+
+        /**
+         * Register handler for method and path; throw router::error if path is malformed
+         */
+        void  add(const method_code method, const std::string path, const handler handler);
+
+        /**
+         * Register coroutine for method and path, replacing any handler; throw router::error if path is malformed
+         */
+        void  add(const method_code method, const std::string path, const coroutine coroutine);
+
+        /**
+         * Register stream for method and path, replacing any handler; throw router::error if path is malformed
+         */
+        void  add(const method_code method, const std::string path, const stream stream);
+
+        /**
+         * Return the handler registered for method and path, if any, and path's parameters; doesn't allocate
+         */
+        match find(const method_code method, const std::string_view path) const;
+    private:
+        // Typedef
+
+        struct node {
+            // Constructors
+
+            ~node();
+
+            // Member Fields
+
+            std::vector<node*>                    children;
+            std::array<coroutine, UNKNOWN_METHOD> coroutines;
+            std::array<handler, UNKNOWN_METHOD>   handlers;
+
+            // Parameter name, if this node is a parameter
+            std::string                           name;
+            node*                                 param = NULL;
+
+            // Static text matched by this node
+            std::string                           prefix;
+            std::array<stream, UNKNOWN_METHOD>    streams;
+        };
+
+        // Member Fields
+
+        node* _root;
+
+        // Member Functions
+
+        const node* _find(const node* node, const method_code method, const std::string_view path, class params& params) const;
+
+        /**
+         * Return the node for path, adding nodes as needed; throw router::error if path is malformed
+         */
+        node*       _insert(const method_code method, const std::string path);
+    };
+}
+
+#endif /* router_h */
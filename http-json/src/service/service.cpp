@@ -7,17 +7,43 @@
 
 #include "service.h"
 
-string service::greeting(header::map headers, class request request) {
-    headers["Content-Type"] = string("application/json");
-    
-    try {
-        if (request.headers()["content-type"] != "application/json")
+string service::greeting(header::map headers, const class request& request) {
+    return this->_greeting(headers, [&request]() {
+        if (request.headers()[field::CONTENT_TYPE] != "application/json")
             throw runtime_error("must have required property 'firstName'");
 
         if (request.body().empty())
             throw runtime_error("must have required property 'firstName'");
-        
-        object* options = parse(request.body());
+
+        return parse(string(request.body()));
+    });
+}
+
+string service::greeting(header::map headers, const url::param::map& params) {
+    return this->_greeting(headers, [&params]() {
+        vector<object*> values;
+
+        // As the JSON body would name them
+        for (const string name: { "firstName", "lastName", "nickname" }) {
+            auto it = params.find(name);
+
+            if (it != params.end())
+                values.push_back(new object(name, encode(it->second.str())));
+        }
+
+        return new object(values);
+    });
+}
+
+mysocket::task<string> service::greeting(const class request& request) {
+    co_return this->greeting({}, request);
+}
+
+string service::_greeting(header::map headers, const function<object*()> options_factory) {
+    headers["Content-Type"] = string("application/json");
+    
+    try {
+        object* options = options_factory();
 
         if (options->type() != object::OBJECT)
             throw runtime_error("must be object");
@@ -64,8 +90,8 @@ string service::greeting(header::map headers, class request request) {
     }
 }
 
-string service::ping(header::map headers) {
-    headers["Content-Type"] = string("application/json");
-
-    return response(encode("Hello, world!"), headers);
+static_response service::ping() {
+    return static_response(OK, encode("Hello, world!"), {
+        { "Content-Type", string("application/json") }
+    });
 }
@@ -11,15 +11,34 @@
 #include "http.h"
 #include "json.h"
 #include "logger.h"
+#include "task.h"
 
 using namespace http;
 using namespace json;
 using namespace std;
 
 struct service {
-    string greeting(header::map headers, class request request);
+    string                 greeting(header::map headers, const class request& request);
+
+    /**
+     * As above, from the query parameters firstName, lastName, and nickname, for GET requests
+     */
+    string                 greeting(header::map headers, const url::param::map& params);
+
+    /**
+     * As above, for coroutine routes; request must outlive the task
+     */
+    mysocket::task<string> greeting(const class request& request);
     
-    string ping(header::map headers);
+    /**
+     * Return the response to every ping; serialize once
+     */
+    static_response        ping();
+private:
+    /**
+     * Greet by the names in the object options_factory returns; it throws if the request is malformed
+     */
+    string                 _greeting(header::map headers, const function<object*()> options_factory);
 };
 
 #endif /* service_h */
@@ -0,0 +1,266 @@
+//
+//  handoff.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "handoff.h"
+
+namespace mysocket {
+    // Non-Member Fields
+
+    // Descriptors and groups per message; Linux accepts at most 253 descriptors at once
+    constexpr size_t _max_descriptors = 253;
+    constexpr size_t _max_groups = 64;
+
+    // Constructors
+
+    handoff::handoff(const std::string path) {
+        this->_path = path;
+    }
+
+    // Member Functions
+
+    void handoff::acknowledge() {
+        if (this->_connection == -1)
+            return;
+
+        char byte = 1;
+
+        if (write(this->_connection, &byte, 1) != 1) {
+            int errnum = errno;
+
+            ::close(this->_connection);
+
+            this->_connection = -1;
+
+            throw mysocket::error(errnum);
+        }
+
+        // The predecessor closes its listener first, then this connection
+        while (read(this->_connection, &byte, 1) > 0)
+            continue;
+
+        ::close(this->_connection);
+
+        this->_connection = -1;
+    }
+
+    void handoff::close() {
+        if (this->_wake[1] != -1) {
+            char byte = 1;
+
+            write(this->_wake[1], &byte, 1);
+        }
+
+        if (this->_thread.joinable())
+            this->_thread.join();
+
+        if (this->_listener != -1) {
+            ::close(this->_listener);
+
+            // Abstract names vanish with their socket
+            if (this->_path[0] != '@')
+                unlink(this->_path.c_str());
+        }
+
+        for (int file_descriptor: { this->_connection, this->_wake[0], this->_wake[1] })
+            if (file_descriptor != -1)
+                ::close(file_descriptor);
+
+        delete this;
+    }
+
+    void handoff::offer(const std::function<std::vector<std::vector<int>>()> descriptors, const std::function<void()> done) {
+        struct sockaddr_un addr;
+        socklen_t          length = local_address(this->_path, addr);
+
+        // Left by an earlier run, or by the predecessor
+        unlink_stale(addr, length);
+
+        this->_listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (this->_listener == -1)
+            throw mysocket::error(errno);
+
+        if (bind(this->_listener, (struct sockaddr *)&addr, length) || listen(this->_listener, 1) || pipe(this->_wake)) {
+            int errnum = errno;
+
+            ::close(this->_listener);
+
+            this->_listener = -1;
+
+            throw mysocket::error(errnum);
+        }
+
+        this->_thread = std::thread([this, descriptors, done]() {
+            while (this->_wait(this->_listener)) {
+                int connection = accept(this->_listener, NULL, NULL);
+
+                if (connection == -1)
+                    continue;
+
+                bool taken = this->_send(connection, descriptors());
+
+                // Release path before the successor learns it's free
+                if (taken) {
+                    ::close(this->_listener);
+
+                    this->_listener = -1;
+                }
+
+                ::close(connection);
+
+                if (taken)
+                    return done();
+            }
+        });
+    }
+
+    std::vector<std::vector<int>> handoff::receive() {
+        struct sockaddr_un addr;
+        socklen_t          length = local_address(this->_path, addr);
+
+        this->_connection = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (this->_connection == -1)
+            throw mysocket::error(errno);
+
+        if (connect(this->_connection, (struct sockaddr *)&addr, length)) {
+            int errnum = errno;
+
+            ::close(this->_connection);
+
+            this->_connection = -1;
+
+            // Nothing offers
+            if (errnum == ENOENT || errnum == ECONNREFUSED)
+                return { };
+
+            throw mysocket::error(errnum);
+        }
+
+        // Group sizes, with every descriptor attached
+        uint32_t      sizes[_max_groups];
+        struct iovec  iov = { sizes, sizeof(sizes) };
+        char          control[CMSG_SPACE(sizeof(int) * _max_descriptors)];
+        struct msghdr message;
+
+        memset(&message, 0, sizeof(message));
+
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+#ifdef __linux__
+        ssize_t len = recvmsg(this->_connection, &message, MSG_CMSG_CLOEXEC);
+#else
+        ssize_t len = recvmsg(this->_connection, &message, 0);
+#endif
+        int     errnum = len == -1 ? errno : EPROTO;
+
+        std::vector<int> received;
+
+        for (struct cmsghdr* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS)
+                continue;
+
+            size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+
+            for (size_t i = 0; i < count; i++) {
+                int file_descriptor;
+
+                memcpy(&file_descriptor, CMSG_DATA(header) + i * sizeof(int), sizeof(int));
+
+                received.push_back(file_descriptor);
+            }
+        }
+
+        std::vector<std::vector<int>> result;
+        size_t                        next = 0;
+
+        for (ssize_t i = 0; len > 0 && i < len / (ssize_t) sizeof(uint32_t); i++) {
+            result.push_back({ });
+
+            for (uint32_t j = 0; j < sizes[i] && next < received.size(); j++)
+                result.back().push_back(received[next++]);
+        }
+
+        // Truncated, or sizes disagree with what arrived
+        if (len <= 0 || len % sizeof(uint32_t) || (message.msg_flags & MSG_CTRUNC) || next != received.size() || result.back().size() != sizes[result.size() - 1]) {
+            for (int file_descriptor: received)
+                ::close(file_descriptor);
+
+            ::close(this->_connection);
+
+            this->_connection = -1;
+
+            throw mysocket::error(errnum);
+        }
+
+        return result;
+    }
+
+    bool handoff::_send(const int connection, const std::vector<std::vector<int>> descriptors) const {
+        std::vector<uint32_t> sizes;
+        std::vector<int>      flattened;
+
+        for (const std::vector<int>& group: descriptors) {
+            sizes.push_back((uint32_t) group.size());
+            flattened.insert(flattened.end(), group.begin(), group.end());
+        }
+
+        if (sizes.empty() || sizes.size() > _max_groups || flattened.size() > _max_descriptors)
+            return false;
+
+        std::vector<char> control(CMSG_SPACE(sizeof(int) * flattened.size()));
+        struct iovec      iov = { sizes.data(), sizes.size() * sizeof(uint32_t) };
+        struct msghdr     message;
+
+        memset(&message, 0, sizeof(message));
+
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+
+        if (flattened.size()) {
+            message.msg_control = control.data();
+            message.msg_controllen = (socklen_t) control.size();
+
+            struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+
+            header->cmsg_level = SOL_SOCKET;
+            header->cmsg_type = SCM_RIGHTS;
+            header->cmsg_len = CMSG_LEN(sizeof(int) * flattened.size());
+
+            memcpy(CMSG_DATA(header), flattened.data(), sizeof(int) * flattened.size());
+        }
+
+        if (sendmsg(connection, &message, 0) != (ssize_t) iov.iov_len)
+            return false;
+
+        char byte;
+
+        // Closed without acknowledging; it failed to serve
+        return this->_wait(connection) && read(connection, &byte, 1) == 1;
+    }
+
+    bool handoff::_wait(const int file_descriptor) const {
+        struct pollfd fds[] = {
+            { file_descriptor, POLLIN, 0 },
+            { this->_wake[0], POLLIN, 0 }
+        };
+
+        while (true) {
+            if (poll(fds, 2, -1) == -1) {
+                if (errno == EINTR)
+                    continue;
+
+                return false;
+            }
+
+            return !fds[1].revents;
+        }
+    }
+}
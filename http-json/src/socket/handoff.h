@@ -0,0 +1,84 @@
+//
+//  handoff.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef handoff_h
+#define handoff_h
+
+#include "socket.h"
+#include <poll.h>       // poll
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mysocket {
+    /**
+     * Passes listening sockets from a running server to its replacement over a Unix-domain socket (SCM_RIGHTS), so
+     * that restarts refuse no connections: the replacement receives them and serves, and only once it acknowledges
+     * does the predecessor stop accepting and drain
+     */
+    class handoff {
+    public:
+        // Constructors
+
+        /**
+         * Hand off over path; a leading '@' names one in Linux's abstract namespace
+         */
+        handoff(const std::string path);
+
+        handoff(const handoff& other) = delete;
+
+        // Member Functions
+
+        /**
+         * Confirm that the received listeners are served, and wait for the predecessor to release path, so that it
+         * may be offered again
+         */
+        void                          acknowledge();
+
+        /**
+         * Stop offering; path is removed unless a successor took it over. Not to be called from offer()'s done
+         */
+        void                          close();
+
+        /**
+         * Listen on path, replacing a stale file, and when a successor connects, send it descriptors(), in groups;
+         * once it acknowledges, release path and call done, on a background thread. A successor that fails first is
+         * forgotten, and the offer stands
+         */
+        void                          offer(const std::function<std::vector<std::vector<int>>()> descriptors, const std::function<void()> done);
+
+        /**
+         * Connect to a predecessor offering listeners, and return them in the groups offered; empty if none offers
+         */
+        std::vector<std::vector<int>> receive();
+    private:
+        // Member Fields
+
+        // To the predecessor, between receive() and acknowledge()
+        int         _connection = -1;
+        int         _listener = -1;
+        std::string _path;
+        std::thread _thread;
+
+        // Written by close() to wake the thread
+        int         _wake[2] = { -1, -1 };
+
+        // Member Functions
+
+        /**
+         * Send descriptors to connection and wait for its acknowledgement; return false if it failed, or if closed
+         */
+        bool _send(const int connection, const std::vector<std::vector<int>> descriptors) const;
+
+        /**
+         * Wait until file_descriptor is readable; return false if closed meanwhile
+         */
+        bool _wait(const int file_descriptor) const;
+    };
+}
+
+#endif /* handoff_h */
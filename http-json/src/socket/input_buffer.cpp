@@ -0,0 +1,156 @@
+//
+//  input_buffer.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "input_buffer.h"
+#include <algorithm>
+#include <vector>
+
+namespace mysocket {
+    // Typedef
+
+    struct block_pool {
+        // Member Fields
+
+        // Idle blocks kept for reuse; the rest are freed
+        static constexpr size_t limit = 64;
+
+        std::vector<char*>      blocks;
+
+        // Constructors
+
+        ~block_pool() {
+            for (char* block: this->blocks)
+                delete[] block;
+        }
+    };
+
+    // Non-Member Fields
+
+    // Buffers are filled and drained on their event loop, so each thread keeps its own blocks
+    thread_local block_pool _blocks;
+
+    // Constructors
+
+    input_buffer::input_buffer(const size_t capacity) {
+        this->_capacity = capacity;
+    }
+
+    input_buffer::~input_buffer() {
+        this->_free();
+    }
+
+    // Member Functions
+
+    size_t input_buffer::append(const std::string_view data) {
+        size_t result = 0;
+
+        while (result < data.length()) {
+            std::span<char> space = this->prepare(data.length() - result);
+
+            if (space.empty())
+                break;
+
+            size_t length = std::min(space.size(), data.length() - result);
+
+            memcpy(space.data(), data.data() + result, length);
+
+            this->commit(length);
+
+            result += length;
+        }
+
+        return result;
+    }
+
+    size_t input_buffer::capacity() const {
+        return this->_capacity;
+    }
+
+    void input_buffer::clear() {
+        this->_free();
+    }
+
+    void input_buffer::commit(const size_t length) {
+        this->_end += length;
+    }
+
+    void input_buffer::consume(const size_t length) {
+        this->_start += std::min(length, this->length());
+
+        // Rewind rather than move what's left
+        if (this->_start == this->_end)
+            this->_start = this->_end = 0;
+    }
+
+    std::string_view input_buffer::data() const {
+        return std::string_view(this->_data + this->_start, this->length());
+    }
+
+    bool input_buffer::empty() const {
+        return this->_start == this->_end;
+    }
+
+    void input_buffer::_free() {
+        if (this->_size == block_size && _blocks.blocks.size() < block_pool::limit)
+            _blocks.blocks.push_back(this->_data);
+        else
+            delete[] this->_data;
+
+        this->_data = NULL;
+        this->_end = this->_size = this->_start = 0;
+    }
+
+    bool input_buffer::full() const {
+        return this->length() >= this->_capacity;
+    }
+
+    size_t input_buffer::length() const {
+        return this->_end - this->_start;
+    }
+
+    std::span<char> input_buffer::prepare(const size_t length) {
+        size_t held = this->length(),
+               wanted = std::min(length, this->_capacity - std::min(held, this->_capacity));
+
+        if (!wanted)
+            return { };
+
+        if (this->_size - this->_end < wanted) {
+            if (this->_size - held >= wanted) {
+                // Move the remainder to the front
+                memmove(this->_data, this->_data + this->_start, held);
+            } else {
+                size_t size = std::max(this->_size * 2, block_size);
+
+                while (size < held + wanted)
+                    size *= 2;
+
+                char* data;
+
+                if (size == block_size && _blocks.blocks.size()) {
+                    data = _blocks.blocks.back();
+
+                    _blocks.blocks.pop_back();
+                } else
+                    data = new char[size];
+
+                if (held)
+                    memcpy(data, this->_data + this->_start, held);
+
+                this->_free();
+
+                this->_data = data;
+                this->_size = size;
+            }
+
+            this->_start = 0;
+            this->_end = held;
+        }
+
+        return std::span<char>(this->_data + this->_end, std::min(this->_size - this->_end, this->_capacity - held));
+    }
+}
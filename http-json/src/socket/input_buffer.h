@@ -0,0 +1,94 @@
+//
+//  input_buffer.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef input_buffer_h
+#define input_buffer_h
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+namespace mysocket {
+    /**
+     * Contiguous bytes received but not yet consumed, so that parsers may scan them in place. Storage starts as a
+     * pooled block, doubles as needed up to capacity, and returns to the pool once drained; consuming only advances
+     * an offset, and the remainder moves to the front only when space is needed
+     */
+    class input_buffer {
+    public:
+        // Member Fields
+
+        // Size of pooled blocks, and of the first allocation
+        static constexpr size_t block_size = 16384;
+
+        // Constructors
+
+        input_buffer(const size_t capacity = SIZE_MAX);
+
+        input_buffer(const input_buffer& other) = delete;
+
+        ~input_buffer();
+
+        // Member Functions
+
+        /**
+         * Copy as much of data as fits, and return its length
+         */
+        size_t           append(const std::string_view data);
+
+        size_t           capacity() const;
+
+        /**
+         * Drop every byte, and return storage to the pool
+         */
+        void             clear();
+
+        /**
+         * Mark length bytes, written into prepare()'s space, as received
+         */
+        void             commit(const size_t length);
+
+        /**
+         * Drop length bytes from the front
+         */
+        void             consume(const size_t length);
+
+        std::string_view data() const;
+
+        bool             empty() const;
+
+        /**
+         * Return true if capacity bytes are held; nothing more can be received until some are consumed
+         */
+        bool             full() const;
+
+        size_t           length() const;
+
+        /**
+         * Return writable space following the data, at least length bytes unless that would exceed capacity; empty if
+         * full
+         */
+        std::span<char>  prepare(const size_t length = block_size);
+    private:
+        // Member Fields
+
+        size_t _capacity;
+        char*  _data = NULL;
+
+        // Data spans [_start, _end) of _size allocated
+        size_t _end = 0;
+        size_t _size = 0;
+        size_t _start = 0;
+
+        // Member Functions
+
+        void _free();
+    };
+}
+
+#endif /* input_buffer_h */
@@ -0,0 +1,141 @@
+//
+//  lifecycle.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "lifecycle.h"
+#include "socket.h"
+
+namespace mysocket {
+#ifndef __linux__
+    // Non-Member Fields
+
+    // Written by the signal handler; one lifecycle per process
+    int _signals[2] = { -1, -1 };
+
+    // Non-Member Functions
+
+    void _notify(const int signum) {
+        int           errnum = errno;
+        unsigned char byte = (unsigned char) signum;
+
+        // Dropped if the pipe is full; the signals pending are read already
+        write(_signals[1], &byte, 1);
+
+        errno = errnum;
+    }
+
+#endif
+    // Constructors
+
+    lifecycle::lifecycle(const std::map<int, handler> handlers) {
+        this->_handlers = handlers;
+#ifdef __linux__
+        sigset_t mask;
+
+        sigemptyset(&mask);
+
+        for (const auto& [signum, handler]: handlers)
+            sigaddset(&mask, signum);
+
+        // Delivered only through the signalfd
+        pthread_sigmask(SIG_BLOCK, &mask, &this->_previous);
+
+        this->_file_descriptor = signalfd(-1, &mask, SFD_CLOEXEC | SFD_NONBLOCK);
+
+        if (this->_file_descriptor == -1) {
+            int errnum = errno;
+
+            pthread_sigmask(SIG_SETMASK, &this->_previous, NULL);
+
+            throw mysocket::error(errnum);
+        }
+#else
+        if (pipe(_signals))
+            throw mysocket::error(errno);
+
+        for (int file_descriptor: _signals) {
+            fcntl(file_descriptor, F_SETFL, O_NONBLOCK);
+            fcntl(file_descriptor, F_SETFD, FD_CLOEXEC);
+        }
+
+        this->_file_descriptor = _signals[0];
+
+        struct sigaction action;
+
+        memset(&action, 0, sizeof(action));
+
+        action.sa_handler = _notify;
+        action.sa_flags = SA_RESTART;
+
+        sigemptyset(&action.sa_mask);
+
+        for (const auto& [signum, handler]: handlers)
+            sigaction(signum, &action, NULL);
+#endif
+    }
+
+    lifecycle::~lifecycle() {
+#ifdef __linux__
+        ::close(this->_file_descriptor);
+
+        pthread_sigmask(SIG_SETMASK, &this->_previous, NULL);
+#else
+        for (const auto& [signum, handler]: this->_handlers)
+            signal(signum, SIG_DFL);
+
+        for (int& file_descriptor: _signals) {
+            ::close(file_descriptor);
+
+            file_descriptor = -1;
+        }
+#endif
+    }
+
+    // Member Functions
+
+    void lifecycle::post(const std::function<void()> task) {
+        this->_reactor.post(task);
+    }
+
+    void lifecycle::_receive() {
+        // Edge-triggered; read until none are left
+        while (true) {
+#ifdef __linux__
+            struct signalfd_siginfo info;
+
+            if (read(this->_file_descriptor, &info, sizeof(info)) != sizeof(info))
+                return;
+
+            int signum = (int) info.ssi_signo;
+#else
+            unsigned char byte;
+
+            if (read(this->_file_descriptor, &byte, 1) != 1)
+                return;
+
+            int signum = byte;
+#endif
+            auto it = this->_handlers.find(signum);
+
+            if (it != this->_handlers.end())
+                it->second();
+        }
+    }
+
+    void lifecycle::run() {
+        uint64_t watch = this->_reactor.add(this->_file_descriptor, reactor::READ, [this](const int) {
+            this->_receive();
+        });
+
+        // Signals that arrived earlier are reported once watched
+        this->_reactor.run();
+        this->_reactor.remove(watch);
+    }
+
+    void lifecycle::stop() {
+        this->_reactor.stop();
+    }
+}
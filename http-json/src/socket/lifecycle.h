@@ -0,0 +1,78 @@
+//
+//  lifecycle.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef lifecycle_h
+#define lifecycle_h
+
+#include "reactor.h"
+#include <csignal>
+#include <functional>
+#include <map>
+#ifdef __linux__
+#include <sys/signalfd.h>
+#endif
+
+namespace mysocket {
+    /**
+     * Runs a process's signal handlers on an event loop, as ordinary code rather than in signal context: signals are
+     * read from a signalfd on Linux, and from a pipe written by the handler elsewhere. The loop sleeps until one
+     * arrives or a task is posted
+     */
+    class lifecycle {
+    public:
+        // Typedef
+
+        using handler = std::function<void()>;
+
+        // Constructors
+
+        /**
+         * Route each signal to its handler. On Linux the signals are blocked on the calling thread, and on threads it
+         * starts later, so construct this before starting any others; one per process
+         */
+        lifecycle(const std::map<int, handler> handlers);
+
+        lifecycle(const lifecycle& other) = delete;
+
+        ~lifecycle();
+
+        // Member Functions
+
+        /**
+         * Run task on the loop's thread, after any handler running
+         */
+        void post(const std::function<void()> task);
+
+        /**
+         * Dispatch signals and posted tasks on the calling thread until stop()
+         */
+        void run();
+
+        void stop();
+    private:
+        // Member Fields
+
+        // signalfd, or the pipe's read end
+        int                     _file_descriptor;
+        std::map<int, handler>  _handlers;
+        class reactor           _reactor;
+#ifdef __linux__
+
+        // Restored on destruction
+        sigset_t                _previous;
+#endif
+
+        // Member Functions
+
+        /**
+         * Call the handlers of every signal pending
+         */
+        void _receive();
+    };
+}
+
+#endif /* lifecycle_h */
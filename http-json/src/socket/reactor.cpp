@@ -0,0 +1,257 @@
+//
+//  reactor.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "reactor.h"
+#include "socket.h"
+
+namespace mysocket {
+    // Non-Member Fields
+
+    thread_local reactor* _current = NULL;
+
+    // Constructors
+
+    reactor::reactor() {
+#ifdef __linux__
+        this->_file_descriptor = epoll_create1(EPOLL_CLOEXEC);
+
+        if (this->_file_descriptor == -1)
+            throw mysocket::error(errno);
+
+        this->_wake = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+        if (this->_wake == -1) {
+            ::close(this->_file_descriptor);
+
+            throw mysocket::error(errno);
+        }
+
+        // Id 0 is reserved for wake ups
+        struct epoll_event event = { EPOLLIN | EPOLLET, { .u64 = 0 } };
+
+        epoll_ctl(this->_file_descriptor, EPOLL_CTL_ADD, this->_wake, &event);
+#else
+        this->_file_descriptor = kqueue();
+
+        if (this->_file_descriptor == -1)
+            throw mysocket::error(errno);
+
+        struct kevent event;
+
+        EV_SET(&event, 0, EVFILT_USER, EV_ADD | EV_CLEAR, 0, 0, NULL);
+
+        kevent(this->_file_descriptor, &event, 1, NULL, 0, NULL);
+#endif
+    }
+
+    reactor::~reactor() {
+        ::close(this->_file_descriptor);
+#ifdef __linux__
+        ::close(this->_wake);
+#endif
+    }
+
+    // Member Functions
+
+    uint64_t reactor::add(const int file_descriptor, const int interests, const callback callback) {
+        uint64_t id = this->_next++;
+        watch&   watch = this->_watches[id] = { file_descriptor, callback, 0 };
+
+        try {
+            this->_control(watch, id, interests, true);
+        } catch (mysocket::error& e) {
+            this->_watches.erase(id);
+
+            throw e;
+        }
+
+        return id;
+    }
+
+    void reactor::_control(const watch& watch, const uint64_t id, const int interests, const bool add) {
+#ifdef __linux__
+        struct epoll_event event = { EPOLLET | EPOLLRDHUP, { .u64 = id } };
+
+        if (interests & READ)
+            event.events |= EPOLLIN;
+
+        if (interests & WRITE)
+            event.events |= EPOLLOUT;
+
+        if (epoll_ctl(this->_file_descriptor, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, watch.file_descriptor, &event))
+            throw mysocket::error(errno);
+#else
+        struct kevent events[2];
+        int           n = 0;
+
+        // Filters are registered individually; only send changes
+        int changed = add ? interests : interests ^ watch.interests;
+
+        if (changed & READ)
+            EV_SET(&events[n++], watch.file_descriptor, EVFILT_READ, interests & READ ? EV_ADD | EV_CLEAR : EV_DELETE, 0, 0, (void *) id);
+
+        if (changed & WRITE)
+            EV_SET(&events[n++], watch.file_descriptor, EVFILT_WRITE, interests & WRITE ? EV_ADD | EV_CLEAR : EV_DELETE, 0, 0, (void *) id);
+
+        if (n && kevent(this->_file_descriptor, events, n, NULL, 0, NULL) == -1)
+            throw mysocket::error(errno);
+#endif
+        this->_watches[id].interests = interests;
+    }
+
+    void reactor::modify(const uint64_t id, const int interests) {
+        auto it = this->_watches.find(id);
+
+        if (it == this->_watches.end() || it->second.file_descriptor == -1 || it->second.interests == interests)
+            return;
+
+        this->_control(it->second, id, interests, false);
+    }
+
+    void reactor::post(const std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(this->_tasks_mutex);
+
+            this->_tasks.push_back(task);
+        }
+
+        this->_wake_up();
+    }
+
+    void reactor::remove(const uint64_t id) {
+        auto it = this->_watches.find(id);
+
+        if (it == this->_watches.end() || it->second.file_descriptor == -1)
+            return;
+
+#ifdef __linux__
+        epoll_ctl(this->_file_descriptor, EPOLL_CTL_DEL, it->second.file_descriptor, NULL);
+#else
+        struct kevent events[2];
+        int           n = 0;
+
+        if (it->second.interests & READ)
+            EV_SET(&events[n++], it->second.file_descriptor, EVFILT_READ, EV_DELETE, 0, 0, NULL);
+
+        if (it->second.interests & WRITE)
+            EV_SET(&events[n++], it->second.file_descriptor, EVFILT_WRITE, EV_DELETE, 0, 0, NULL);
+
+        kevent(this->_file_descriptor, events, n, NULL, 0, NULL);
+#endif
+        // The callback may be running
+        it->second.file_descriptor = -1;
+
+        this->_removed.push_back(id);
+    }
+
+    reactor* reactor::current() {
+        return _current;
+    }
+
+    void reactor::_dispatch(const std::chrono::milliseconds timeout) {
+        constexpr int capacity = 256;
+
+        _current = this;
+
+        bool indefinite = timeout == std::chrono::milliseconds::max();
+#ifdef __linux__
+        struct epoll_event events[capacity];
+
+        int n = epoll_wait(this->_file_descriptor, events, capacity, indefinite ? -1 : (int) std::min((long long) timeout.count(), (long long) INT_MAX));
+#else
+        struct kevent   events[capacity];
+        struct timespec ts = { (time_t) (timeout.count() / 1000), (long) (timeout.count() % 1000) * 1000000 };
+
+        int n = kevent(this->_file_descriptor, NULL, 0, events, capacity, indefinite ? NULL : &ts);
+#endif
+        if (n == -1 && errno != EINTR)
+            throw mysocket::error(errno);
+
+        for (int i = 0; i < n; i++) {
+#ifdef __linux__
+            uint64_t id = events[i].data.u64;
+            int      ready = (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR) ? READ : 0) | (events[i].events & EPOLLOUT ? WRITE : 0);
+
+            if (!id) {
+                uint64_t value;
+
+                while (read(this->_wake, &value, sizeof(value)) > 0)
+                    continue;
+
+                continue;
+            }
+#else
+            if (events[i].filter == EVFILT_USER)
+                continue;
+
+            uint64_t id = (uint64_t) events[i].udata;
+            int      ready = events[i].filter == EVFILT_WRITE ? WRITE : READ;
+#endif
+            auto it = this->_watches.find(id);
+
+            if (it != this->_watches.end() && it->second.file_descriptor != -1)
+                it->second.function(ready);
+        }
+
+        std::vector<std::function<void()>> tasks;
+
+        {
+            std::lock_guard<std::mutex> lock(this->_tasks_mutex);
+
+            tasks.swap(this->_tasks);
+        }
+
+        for (const std::function<void()>& task: tasks)
+            task();
+
+        this->_timers.run();
+
+        for (uint64_t id: this->_removed)
+            this->_watches.erase(id);
+
+        this->_removed.clear();
+    }
+
+    int reactor::file_descriptor() const {
+        return this->_file_descriptor;
+    }
+
+    void reactor::poll() {
+        this->_dispatch(std::chrono::milliseconds(0));
+    }
+
+    void reactor::run() {
+        this->_running.store(true);
+
+        // Wait no longer than the next timer
+        while (this->_running.load())
+            this->_dispatch(this->_timers.next());
+    }
+
+    void reactor::stop() {
+        this->_running.store(false);
+        this->_wake_up();
+    }
+
+    class timer_wheel& reactor::timers() {
+        return this->_timers;
+    }
+
+    void reactor::_wake_up() {
+#ifdef __linux__
+        uint64_t value = 1;
+
+        write(this->_wake, &value, sizeof(value));
+#else
+        struct kevent event;
+
+        EV_SET(&event, 0, EVFILT_USER, 0, NOTE_TRIGGER, 0, NULL);
+
+        kevent(this->_file_descriptor, &event, 1, NULL, 0, NULL);
+#endif
+    }
+}
@@ -0,0 +1,144 @@
+//
+//  reactor.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef reactor_h
+#define reactor_h
+
+#include "timer_wheel.h"
+#include "util.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#else
+#include <sys/event.h>  // kqueue
+#endif
+#include <unistd.h>
+
+namespace mysocket {
+    /**
+     * Edge-triggered readiness loop over file descriptors; epoll on Linux, kqueue elsewhere.
+     * Watches are added, modified, and removed on the loop's thread; post() may be called from any thread
+     */
+    class reactor {
+    public:
+        // Typedef
+
+        enum interest {
+            READ = 1,
+            WRITE = 2
+        };
+
+        /**
+         * Called with the interests that are ready; READ also signals hang up and errors
+         */
+        using callback = std::function<void(const int events)>;
+
+        // Constructors
+
+        reactor();
+
+        reactor(const reactor& other) = delete;
+
+        ~reactor();
+
+        // Member Functions
+
+        /**
+         * Watch file_descriptor for interests and return the watch's id
+         */
+        uint64_t add(const int file_descriptor, const int interests, const callback callback);
+
+        /**
+         * Return the reactor last dispatching on this thread, i.e. the event loop running here, if any
+         */
+        static reactor* current();
+
+        /**
+         * Return the descriptor that becomes readable when events are pending, to nest this reactor in another loop
+         */
+        int      file_descriptor() const;
+
+        /**
+         * Replace the interests of watch id
+         */
+        void     modify(const uint64_t id, const int interests);
+
+        /**
+         * Dispatch pending events and tasks without waiting
+         */
+        void     poll();
+
+        /**
+         * Run task on the loop's thread after pending events, and wake the loop
+         */
+        void     post(const std::function<void()> task);
+
+        /**
+         * Stop watching; the callback isn't called again, even for events already received
+         */
+        void     remove(const uint64_t id);
+
+        /**
+         * Dispatch events, tasks, and due timers on the calling thread until stop()
+         */
+        void     run();
+
+        void     stop();
+
+        /**
+         * Return the loop's timers; arm and cancel them on the loop's thread
+         */
+        class timer_wheel& timers();
+    private:
+        // Typedef
+
+        struct watch {
+            // Member Fields
+
+            int      file_descriptor;
+            callback function;
+            int      interests;
+        };
+
+        // Member Fields
+
+        int                                 _file_descriptor;
+        uint64_t                            _next = 1;
+
+        // Watches removed while dispatching, erased after
+        std::vector<uint64_t>               _removed;
+        std::atomic<bool>                   _running = false;
+        std::vector<std::function<void()>>  _tasks;
+        std::mutex                          _tasks_mutex;
+        class timer_wheel                   _timers;
+        std::unordered_map<uint64_t, watch> _watches;
+#ifdef __linux__
+
+        // Wakes the loop for posted tasks
+        int                                 _wake;
+#endif
+
+        // Member Functions
+
+        void _control(const watch& watch, const uint64_t id, const int interests, const bool add);
+
+        /**
+         * Dispatch events, waiting up to timeout, or indefinitely if it's milliseconds::max(); then tasks and due timers
+         */
+        void _dispatch(const std::chrono::milliseconds timeout);
+
+        void _wake_up();
+    };
+}
+
+#endif /* reactor_h */
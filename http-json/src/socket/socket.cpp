@@ -8,43 +8,272 @@
 #include "socket.h"
 
 namespace mysocket {
+    // Non-Member Fields
+
+    // Room for one UDP_GRO or UDP_SEGMENT control message
+    constexpr size_t _control_size = CMSG_SPACE(sizeof(int));
+
     // Non-Member Functions
 
+    // Return a non-blocking socket listening on address
+    int _bind(const struct sockaddr* address, const socklen_t length, const int backlog, const bool reuse_port) {
+        int file_descriptor = ::socket(address->sa_family, SOCK_STREAM, 0);
+
+        if (file_descriptor == -1)
+            throw mysocket::error(errno);
+
+        int opt = 1;
+
+        // Accepted connections inherit O_NONBLOCK on some platforms, but not Linux
+        if ((address->sa_family == AF_INET && setsockopt(file_descriptor, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt))) ||
+            (reuse_port && setsockopt(file_descriptor, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt))) ||
+            fcntl(file_descriptor, F_SETFL, O_NONBLOCK) ||
+            bind(file_descriptor, address, length) ||
+            listen(file_descriptor, backlog)) {
+            int errnum = errno;
+
+            ::close(file_descriptor);
+
+            throw mysocket::error(errnum);
+        }
+
+        return file_descriptor;
+    }
+
+    // Return when timeout elapses from now; time_point::max() if never
+    std::chrono::steady_clock::time_point _deadline(const std::chrono::milliseconds timeout) {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        if (timeout >= std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::time_point::max() - now))
+            return std::chrono::steady_clock::time_point::max();
+
+        return now + timeout;
+    }
+
+    socklen_t local_address(const std::string path, struct sockaddr_un& address) {
+        memset(&address, 0, sizeof(address));
+
+        address.sun_family = AF_UNIX;
+
+        if (path.empty() || path.length() >= sizeof(address.sun_path))
+            throw mysocket::error(path.empty() ? EINVAL : ENAMETOOLONG);
+
+#ifdef __linux__
+        if (path[0] == '@') {
+            // Leading NUL, then the name; not NUL-terminated
+            memcpy(address.sun_path + 1, path.data() + 1, path.length() - 1);
+
+            return (socklen_t) (offsetof(struct sockaddr_un, sun_path) + path.length());
+        }
+#endif
+        memcpy(address.sun_path, path.data(), path.length());
+
+        return (socklen_t) sizeof(address);
+    }
+
     std::string _recv(const int file_descriptor) {
-        char buff[1024] = {0};
-            
-        ssize_t len = recv(file_descriptor, buff, 1024, 0);
+        std::string result(1024, '\0');
+
+        ssize_t len = recv(file_descriptor, result.data(), result.length(), 0);
 
         if (len == -1)
             throw mysocket::error(errno);
 
-        buff[len] = '\0';
-        
-        return trim_end(std::string(buff));
+        // Up to any NUL, trimmed in place
+        len = strnlen(result.data(), len);
+
+        while (len > 0 && isspace(result[len - 1]))
+            len--;
+
+        result.resize(len);
+
+        return result;
     }
 
-    int _send(const int file_descriptor, const std::string message) {
-        ssize_t len = ::send(file_descriptor, message.c_str(), message.length(), MSG_NOSIGNAL);
-            
-        if (len == -1)
+    size_t _recv(const int file_descriptor, std::string& buffer) {
+        size_t length = buffer.length();
+
+        buffer.resize(length + 16384);
+
+        ssize_t len = ::recv(file_descriptor, buffer.data() + length, buffer.length() - length, 0);
+
+        if (len == -1) {
+            buffer.resize(length);
+
             throw mysocket::error(errno);
-        
-        return (int) len;
+        }
+
+        buffer.resize(length + len);
+
+        return len;
+    }
+
+    size_t _send(const int file_descriptor, const std::vector<std::string_view>& messages) {
+        std::vector<struct iovec> iov;
+
+        for (std::string_view message: messages)
+            if (message.length())
+                iov.push_back({ (void *) message.data(), message.length() });
+
+        size_t index = 0,
+               result = 0;
+
+        while (index < iov.size()) {
+            struct msghdr msg;
+
+            memset(&msg, 0, sizeof(msg));
+
+            msg.msg_iov = &iov[index];
+            msg.msg_iovlen = std::min(iov.size() - index, (size_t) IOV_MAX);
+
+            ssize_t len = sendmsg(file_descriptor, &msg, MSG_NOSIGNAL);
+
+            if (len == -1) {
+                if (errno == EINTR)
+                    continue;
+
+                throw mysocket::error(errno);
+            }
+
+            result += len;
+
+            // Skip segments sent in full, then trim the one sent in part
+            while (index < iov.size() && (size_t) len >= iov[index].iov_len)
+                len -= iov[index++].iov_len;
+
+            if (index < iov.size()) {
+                iov[index].iov_base = (char *) iov[index].iov_base + len;
+                iov[index].iov_len -= len;
+            }
+        }
+
+        return result;
+    }
+
+    size_t _sendfile(const int file_descriptor, const int in_file_descriptor, off_t offset, const size_t length) {
+        size_t result = 0;
+
+        while (result < length) {
+#ifdef __linux__
+            ssize_t len = ::sendfile(file_descriptor, in_file_descriptor, &offset, length - result);
+
+            if (len == -1) {
+                if (errno == EINTR)
+                    continue;
+
+                throw mysocket::error(errno);
+            }
+
+            // File was truncated
+            if (len == 0)
+                break;
+#else
+            off_t len = length - result;
+
+            // Bytes may have been sent before an interruption
+            int status = ::sendfile(in_file_descriptor, file_descriptor, offset, &len, NULL, 0);
+
+            if (status == -1 && errno != EINTR && errno != EAGAIN)
+                throw mysocket::error(errno);
+
+            // File was truncated
+            if (status == 0 && len == 0)
+                break;
+
+            offset += len;
+#endif
+            result += len;
+        }
+
+        return result;
+    }
+
+    int _send(const int file_descriptor, const std::string& message) {
+        size_t result = 0;
+
+        // Retry partial writes
+        while (result < message.length()) {
+            ssize_t len = ::send(file_descriptor, message.c_str() + result, message.length() - result, MSG_NOSIGNAL);
+
+            if (len == -1) {
+                if (errno == EINTR)
+                    continue;
+
+                throw mysocket::error(errno);
+            }
+
+            result += len;
+        }
+
+        return (int) result;
+    }
+
+    void unlink_stale(const struct sockaddr_un& address, const socklen_t length) {
+        // Abstract
+        if (!address.sun_path[0])
+            return;
+
+        struct stat info;
+
+        if (stat(address.sun_path, &info) || !S_ISSOCK(info.st_mode))
+            return;
+
+        int file_descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (file_descriptor == -1)
+            return;
+
+        if (connect(file_descriptor, (const struct sockaddr *)&address, length) && errno == ECONNREFUSED)
+            unlink(address.sun_path);
+
+        ::close(file_descriptor);
+    }
+
+    // Wait until events are ready on file_descriptor; return false if deadline passes first
+    bool _wait(const int file_descriptor, const short events, const std::chrono::steady_clock::time_point deadline) {
+        struct pollfd fd = { file_descriptor, events, 0 };
+
+        while (true) {
+            int timeout = -1;
+
+            if (deadline != std::chrono::steady_clock::time_point::max()) {
+                std::chrono::milliseconds remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+
+                timeout = (int) std::clamp(remaining.count(), (std::chrono::milliseconds::rep) 0, (std::chrono::milliseconds::rep) INT_MAX);
+            }
+
+            int result = poll(&fd, 1, timeout);
+
+            if (result == -1) {
+                if (errno == EINTR)
+                    continue;
+
+                throw mysocket::error(errno);
+            }
+
+            return result > 0;
+        }
     }
 
     // Constructors
 
-    tcp_server::connection::connection(tcp_server* parent, const int file_descriptor) {
+    tcp_server::connection::connection(tcp_server* parent, const int file_descriptor): _buffer(parent->_options.buffer_capacity) {
         this->_parent = parent;
         this->_file_descriptor = file_descriptor;
     }
 
+    tcp_server::registry::registry() {
+        for (std::atomic<slot*>& chunk: this->_chunks)
+            chunk.store(NULL);
+    }
+
     error::error(const int errnum) {
         this->_errnum = errnum;
         this->_what = std::strerror(this->_errnum);
     }
 
-    tcp_client::tcp_client(const std::string host, const int port) {
+    tcp_client::tcp_client(const std::string host, const int port, const std::chrono::milliseconds timeout) {
+        this->_address = NULL;
         this->_file_descriptor = ::socket(AF_INET, SOCK_STREAM, 0);
             
         if (this->_file_descriptor == -1)
@@ -58,14 +287,64 @@ namespace mysocket {
         // Convert port to network byte order
         addr.sin_port = htons(port);
         
-        if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) == -1)
-            throw mysocket::error(errno);
+        // Returns 0 if host isn't an address
+        if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+            ::close(this->_file_descriptor);
+
+            throw mysocket::error(EINVAL);
+        }
+
+        std::chrono::steady_clock::time_point deadline = _deadline(timeout);
+        int                                   flags = fcntl(this->_file_descriptor, F_GETFL);
+
+        // Connect without blocking, so as to give up at the deadline
+        if (deadline != std::chrono::steady_clock::time_point::max())
+            fcntl(this->_file_descriptor, F_SETFL, flags | O_NONBLOCK);
         
         // Returns 0 for success, -1 otherwise
         if (connect(this->_file_descriptor, (struct sockaddr *)&addr, sizeof(addr))) {
-            ::close(this->_file_descriptor);
-            
+            int errnum = errno;
+
+            if (errnum == EINPROGRESS) {
+                socklen_t length = sizeof(errnum);
+
+                if (!_wait(this->_file_descriptor, POLLOUT, deadline))
+                    errnum = ETIMEDOUT;
+                else if (getsockopt(this->_file_descriptor, SOL_SOCKET, SO_ERROR, &errnum, &length))
+                    errnum = errno;
+            }
+
+            if (errnum) {
+                ::close(this->_file_descriptor);
+
+                throw mysocket::error(errnum);
+            }
+        }
+
+        fcntl(this->_file_descriptor, F_SETFL, flags);
+
+        int opt = 1;
+
+        // Requests are written whole; don't hold back their last segment
+        setsockopt(this->_file_descriptor, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+    }
+
+    tcp_client::tcp_client(const std::string path) {
+        struct sockaddr_un addr;
+        socklen_t          length = local_address(path, addr);
+
+        this->_address = NULL;
+        this->_file_descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (this->_file_descriptor == -1)
             throw mysocket::error(errno);
+
+        if (connect(this->_file_descriptor, (struct sockaddr *)&addr, length)) {
+            int errnum = errno;
+
+            ::close(this->_file_descriptor);
+
+            throw mysocket::error(errnum);
         }
     }
 
@@ -119,15 +398,8 @@ namespace mysocket {
                     continue;
 
                 class connection* connection = new class connection(this, file_descriptor);
-                
-                this->_mutex.lock();
-                this->_connections.push_back(connection);
-                
-                // Sort into place
-                for (size_t i = this->_connections.size() - 1; i > 0 && this->_connections[i] < this->_connections[i - 1]; i--)
-                    std::swap(this->_connections[i], this->_connections[i - 1]);
-                
-                this->_mutex.unlock();
+
+                connection->_id = this->_connections.insert(connection);
                 this->_handler(connection);
             }
         });
@@ -137,6 +409,78 @@ namespace mysocket {
         this->_handler = handler;
     }
 
+    tcp_server::tcp_server(const int port, const std::function<void(connection*)> handler, const struct options options) {
+        this->_handler = handler;
+        this->_options = options;
+
+#ifndef __linux__
+        // BSD reuse ports don't balance TCP connections; the last bound takes them all
+        this->_options.reuse_port = false;
+#endif
+        memset(&this->_address, 0, sizeof(this->_address));
+
+        // Listen for any IP address
+        this->_address.sin_addr.s_addr = INADDR_ANY;
+
+        // IPv4
+        this->_address.sin_family = AF_INET;
+
+        // Convert port to network byte order
+        this->_address.sin_port = htons(port);
+        this->_address_length = sizeof(this->_address);
+
+        this->_open((struct sockaddr *)&this->_address, this->_address_length);
+    }
+
+    tcp_server::tcp_server(const std::string path, const std::function<void(connection*)> handler, const struct options options) {
+        this->_handler = handler;
+        this->_options = options;
+        this->_path = path;
+
+        // Only one listener may own a path
+        this->_options.reuse_port = false;
+
+        struct sockaddr_un addr;
+        socklen_t          length = local_address(path, addr);
+
+        // Left by an earlier run
+        unlink_stale(addr, length);
+
+        this->_open((struct sockaddr *)&addr, length);
+    }
+
+    tcp_server::tcp_server(const std::vector<int> listeners, const std::function<void(connection*)> handler, const struct options options) {
+        if (listeners.empty())
+            throw mysocket::error(EINVAL);
+
+        this->_handler = handler;
+        this->_options = options;
+
+        this->_start(listeners);
+    }
+
+    udp_socket::arena::arena(const size_t capacity, const size_t message_size) {
+        this->_message_size = message_size;
+
+        this->_buffers.resize(capacity * message_size);
+        this->_controls.resize(capacity * _control_size);
+        this->_datagrams.resize(capacity);
+        this->_iov.resize(capacity);
+        this->_messages.resize(capacity);
+        this->_names.resize(capacity);
+
+        for (size_t i = 0; i < capacity; i++) {
+            struct msghdr& header = this->_messages[i].msg_hdr;
+
+            this->_iov[i].iov_base = &this->_buffers[i * message_size];
+
+            header.msg_name = &this->_names[i];
+            header.msg_iov = &this->_iov[i];
+            header.msg_iovlen = 1;
+            header.msg_control = &this->_controls[i * _control_size];
+        }
+    }
+
     udp_client::udp_client(const std::string host, const int port) {
         this->_file_descriptor = ::socket(AF_INET, SOCK_DGRAM, 0);
             
@@ -198,6 +542,11 @@ namespace mysocket {
 
     tcp_server::~tcp_server() { }
 
+    tcp_server::registry::~registry() {
+        for (std::atomic<slot*>& chunk: this->_chunks)
+            delete[] chunk.load();
+    }
+
     udp_client::~udp_client() { }
 
     udp_server::~udp_server() { }
@@ -205,147 +554,1237 @@ namespace mysocket {
     // Member Functions
 
     void tcp_server::connection::_close() {
-        if (::close(this->_file_descriptor))
-            throw mysocket::error(errno);
+        int result = ::close(this->_file_descriptor),
+            errnum = errno;
 
+        // Already unregistered, so free it either way
         delete this;
-    }
-
-    int tcp_server::_find_connection(const class connection* connection) {
-        return this->_find_connection(connection, 0, this->_connections.size());
-    }
 
-    int tcp_server::_find_connection(const class connection* connection, const size_t start, const size_t end) {
-        if (start == end)
-            return -1;
-        
-        size_t len = floor((end - start) / 2);
-        
-        if (this->_connections[start + len] == connection)
-            return (int) (start + len);
-        
-        if (this->_connections[start + len] > connection)
-            return this->_find_connection(connection, start, start + len);
-        
-        return this->_find_connection(connection, start + len + 1, end);
+        if (result)
+            throw mysocket::error(errnum);
     }
 
-    void tcp_server::connection::close() {
-        this->_parent->close(this);
-    }
+    void tcp_server::_accept(const size_t loop) {
+        while (true) {
+#ifdef __linux__
+            int file_descriptor = accept4(this->_loops[loop]->listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+            int file_descriptor = accept(this->_loops[loop]->listener, NULL, NULL);
 
-    void tcp_client::close() {
-        if (::close(this->_file_descriptor)) 
-            throw mysocket::error(errno);
+            if (file_descriptor != -1)
+                fcntl(file_descriptor, F_SETFL, O_NONBLOCK);
+#endif
+            if (file_descriptor == -1) {
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
 
-        delete this;
-    }
+                // Drained, or out of file descriptors; retry on the next connection
+                return;
+            }
 
-    void tcp_server::close() {
-        this->_shut_down.store(true);
-        this->_mutex.lock();
-        
-        if (::close(this->_file_descriptor)) {
-            this->_mutex.unlock();
+            class connection* connection = new class connection(this, file_descriptor);
 
-            throw mysocket::error(errno);
-        }
-        
-        this->_listener.join();
+            // Keep it on the accepting loop if it has its own listener, otherwise round robin
+            connection->_loop = this->_options.reuse_port ? loop : this->_next_loop++ % this->_loops.size();
+            connection->_reactor = &this->_loops[connection->_loop]->reactor;
 
-        for (size_t i = 0; i < this->_connections.size(); i++) {
-            if (::close(this->_connections[i]->_file_descriptor)) {
-                this->_mutex.unlock();
+            connection->_id = this->_connections.insert(connection);
 
-                throw mysocket::error(errno);
-            }
-                
-            delete this->_connections[i];
+            if (connection->_loop == loop)
+                this->_serve(connection);
+            else
+                connection->_reactor->post([this, connection]() {
+                    this->_serve(connection);
+                });
         }
-
-        this->_mutex.unlock();
-        
-        delete this;
     }
 
-    void udp_socket::close() {
-        if (::close(this->_file_descriptor))
-            throw mysocket::error(errno);
-        
-        delete this->_address;
-        delete this;
+    bool tcp_server::connection::awaiter::await_ready() const {
+        return this->ready || this->connection->_released;
     }
 
-    void tcp_server::close(class connection* connection) {
-        this->_mutex.lock();
-        
-        int index = this->_find_connection(connection);
+    bool tcp_server::connection::awaiter::await_resume() const {
+        return !this->connection->_released;
+    }
 
-        if (index == -1)
-            return this->_mutex.unlock();
+    void tcp_server::connection::awaiter::await_suspend(const std::coroutine_handle<> handle) const {
+        * this->waiter = handle;
+    }
 
-        try {
-            connection->_close();
-        } catch (mysocket::error& e) {
-            this->_mutex.unlock();
+    const udp_socket::datagram* udp_socket::arena::begin() const {
+        return this->_datagrams.data();
+    }
 
-            throw e;
-        }
+    std::string_view tcp_server::connection::buffer() const {
+        return this->_buffer.data();
+    }
 
-        this->_connections.erase(this->_connections.begin() + index);
-        this->_mutex.unlock();
+    size_t udp_socket::arena::capacity() const {
+        return this->_datagrams.size();
     }
 
-    std::vector<tcp_server::connection*> tcp_server::connections() {
-        this->_mutex.lock();
+    void tcp_server::connection::close() {
+        if (!this->_reactor)
+            return this->_parent->close(this);
 
-        std::vector<connection*> temp = this->_connections;
+        tcp_server* parent = this->_parent;
+        uint64_t    id = this->_id;
 
-        this->_mutex.unlock();
+        // By handle; the connection may be released before this runs
+        this->_reactor->post([parent, id]() {
+            class connection* connection = parent->_connections.find(id);
 
-        return temp;
+            if (connection)
+                parent->_release(connection, true);
+        });
     }
 
-    int error::errnum() const {
-        return this->_errnum;
+    void tcp_server::connection::consume(const size_t length) {
+        this->_buffer.consume(length);
     }
 
-    std::string tcp_server::connection::recv() const {
-        return _recv(this->_file_descriptor);
+    std::shared_ptr<void>& tcp_server::connection::context() {
+        return this->_context;
     }
 
-    std::string tcp_client::recv() const {
-        return _recv(this->_file_descriptor);
-    }
+    void tcp_server::connection::cork(const bool value) const {
+        int option = value;
 
-    std::string udp_socket::recvfrom() const {
-        char      buff[1024];
-        socklen_t addrlen = sizeof(* this->_address);
-        ssize_t   len = ::recvfrom(this->_file_descriptor, (char *)buff, 1024, MSG_WAITALL, (struct sockaddr *)this->_address, &addrlen);
-        
-        if (len == -1)
-            throw mysocket::error(errno);
-        
-        buff[len] = '\0';
-        
-        return std::string(buff);
+#ifdef __linux__
+        setsockopt(this->_file_descriptor, IPPROTO_TCP, TCP_CORK, &option, sizeof(option));
+#else
+        setsockopt(this->_file_descriptor, IPPROTO_TCP, TCP_NOPUSH, &option, sizeof(option));
+#endif
     }
 
-    int tcp_server::connection::send(const std::string message) const {
-        return _send(this->_file_descriptor, message);
+    const udp_socket::datagram* udp_socket::arena::end() const {
+        return this->_datagrams.data() + this->_size;
     }
 
-    int tcp_client::send(const std::string message) const {
-        return _send(this->_file_descriptor, message);
-    }
+    struct tcp_server::connection::credentials tcp_server::connection::credentials() const {
+        struct credentials result;
 
-    int udp_socket::sendto(const std::string message) const {
-        ssize_t len = ::sendto(this->_file_descriptor, (const char *)message.c_str(), message.length(), 0, (const struct sockaddr *)this->_address, sizeof(* this->_address));
-        
-        if (len == -1)
+#ifdef __linux__
+        struct ucred peer;
+        socklen_t    length = sizeof(peer);
+
+        if (getsockopt(this->_file_descriptor, SOL_SOCKET, SO_PEERCRED, &peer, &length))
             throw mysocket::error(errno);
-        
-        return (int) len;
+
+        result.pid = peer.pid;
+        result.uid = peer.uid;
+        result.gid = peer.gid;
+#else
+        socklen_t length = sizeof(result.pid);
+
+        if (getpeereid(this->_file_descriptor, &result.uid, &result.gid) ||
+            getsockopt(this->_file_descriptor, SOL_LOCAL, LOCAL_PEERPID, &result.pid, &length))
+            throw mysocket::error(errno);
+#endif
+        return result;
+    }
+
+    size_t tcp_server::drain(const std::chrono::milliseconds timeout) {
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::min(timeout, std::chrono::milliseconds(INT_MAX));
+
+        // Others may serve on the listeners, and so on the path, from now on
+        this->_path.clear();
+
+        for (size_t i = 0; i < this->_loops.size(); i++) {
+            event_loop* loop = this->_loops[i].get();
+
+            loop->reactor.post([this, loop]() {
+                loop->draining = true;
+
+                // Stop accepting, but keep the listener; a successor may hold it too
+#ifdef __linux__
+                if (loop->ring)
+                    loop->ring->cancel(loop->listener);
+#endif
+                if (loop->watch)
+                    loop->reactor.remove(loop->watch);
+
+                loop->watch = 0;
+
+                // Releasing erases from the set
+                std::vector<class connection*> connections(loop->connections.begin(), loop->connections.end());
+
+                for (class connection* connection: connections)
+                    this->_release(connection, true);
+            });
+        }
+
+        while (true) {
+            size_t result = 0;
+
+            // Counted only, never dereferenced; loops free connections meanwhile
+            this->_connections.for_each([&result](class connection*) {
+                result++;
+            });
+
+            if (!result || std::chrono::steady_clock::now() >= deadline)
+                return result;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    tcp_server::connection* tcp_server::registry::find(const uint64_t handle) const {
+        slot* slot = this->_slot((uint32_t) handle);
+
+        if (!slot || slot->generation.load(std::memory_order_acquire) != (uint32_t) (handle >> 32))
+            return NULL;
+
+        return slot->connection.load(std::memory_order_acquire);
+    }
+
+    size_t tcp_server::connection::flush(const bool more) {
+#ifdef __linux__
+        if (this->_ring) {
+            this->_submit();
+
+            return 0;
+        }
+#endif
+        size_t result = this->_write(more);
+
+        if (result)
+            this->_progress = true;
+
+        // Resume when writable
+        if (this->_reactor)
+            this->_reactor->modify(this->_watch, this->_queue.empty() ? reactor::READ : reactor::READ | reactor::WRITE);
+
+        return result;
+    }
+
+    std::vector<int> tcp_server::listeners() const {
+        std::vector<int> result;
+
+        for (const std::unique_ptr<event_loop>& loop: this->_loops)
+            if (std::find(result.begin(), result.end(), loop->listener) == result.end())
+                result.push_back(loop->listener);
+
+        return result;
+    }
+
+#ifdef __linux__
+    void tcp_server::_listen(const size_t loop) {
+        event_loop* event_loop = this->_loops[loop].get();
+
+        event_loop->ring->accept(event_loop->listener, [this, event_loop, loop](const int result, const uint32_t flags) {
+            if (result >= 0) {
+                class connection* connection = new class connection(this, result);
+
+                connection->_loop = loop;
+                connection->_reactor = &event_loop->reactor;
+                connection->_ring = event_loop->ring.get();
+
+                connection->_id = this->_connections.insert(connection);
+                this->_serve(connection);
+            }
+
+            // Stopped early, e.g. out of file descriptors
+            if (!(flags & IORING_CQE_F_MORE))
+                this->_listen(loop);
+        });
+    }
+
+#endif
+    void tcp_server::registry::for_each(const std::function<void(connection*)> function) const {
+        uint32_t size = this->_size.load(std::memory_order_acquire);
+
+        for (uint32_t i = 0; i < size; i++) {
+            slot*             slot = this->_slot(i);
+            class connection* connection = slot ? slot->connection.load(std::memory_order_acquire) : NULL;
+
+            if (connection)
+                function(connection);
+        }
+    }
+
+    std::function<void(const std::function<void()> task)> tcp_server::connection::hold() {
+        class connection*   connection = this;
+        tcp_server*         parent = this->_parent;
+        class reactor*      reactor = this->_reactor;
+        std::weak_ptr<bool> lifetime = this->_lifetime;
+
+        this->_held++;
+
+        return [connection, lifetime, parent, reactor](const std::function<void()> task) {
+            reactor->post([connection, lifetime, parent, task]() {
+                // Released meanwhile
+                if (lifetime.expired() || connection->_released)
+                    return;
+
+                connection->_held--;
+
+                try {
+                    task();
+                } catch (mysocket::error& e) {
+                    // Sending failed, e.g. the peer reset
+                    if (!lifetime.expired())
+                        parent->_release(connection, false);
+
+                    return;
+                }
+
+                if (!lifetime.expired() && connection->_closing)
+                    parent->_release(connection, true);
+            });
+        };
+    }
+
+    std::weak_ptr<bool> tcp_server::connection::lifetime() const {
+        return this->_lifetime;
+    }
+
+    uint64_t tcp_server::registry::insert(class connection* connection) {
+        uint64_t head = this->_free.load(std::memory_order_acquire);
+        uint32_t index;
+
+        // Reuse a free slot
+        while (true) {
+            if (!(uint32_t) head) {
+                index = this->_size.load(std::memory_order_relaxed);
+
+                if (index >= _chunk_size * std::size(this->_chunks))
+                    throw mysocket::error(EMFILE);
+
+                // Claim a fresh slot, allocating its chunk if this is the first
+                if (!this->_size.compare_exchange_weak(index, index + 1, std::memory_order_acq_rel))
+                    continue;
+
+                std::atomic<slot*>& chunk = this->_chunks[index / _chunk_size];
+
+                if (!chunk.load(std::memory_order_acquire)) {
+                    slot* expected = NULL;
+                    slot* chunk_slots = new slot[_chunk_size];
+
+                    if (!chunk.compare_exchange_strong(expected, chunk_slots, std::memory_order_acq_rel))
+                        delete[] chunk_slots;
+                }
+
+                break;
+            }
+
+            index = (uint32_t) head - 1;
+
+            uint64_t next = (head >> 32 << 32) | this->_slot(index)->next.load(std::memory_order_relaxed);
+
+            if (this->_free.compare_exchange_weak(head, next, std::memory_order_acq_rel))
+                break;
+        }
+
+        slot* slot = this->_slot(index);
+
+        slot->connection.store(connection, std::memory_order_release);
+
+        return ((uint64_t) slot->generation.load(std::memory_order_relaxed) << 32) | index;
+    }
+
+    void udp_socket::offload(const bool value) const {
+#ifdef __linux__
+        int option = value;
+
+        if (setsockopt(this->_file_descriptor, SOL_UDP, UDP_GRO, &option, sizeof(option)))
+            throw mysocket::error(errno);
+#endif
+    }
+
+    void tcp_server::connection::queue(const std::string_view message, const std::shared_ptr<const void> owner) {
+        if (message.length())
+            this->_queue.push_back({ message, -1, 0, 0, owner });
+    }
+
+    void tcp_server::connection::queue(const std::shared_ptr<const std::string> message) {
+        this->queue(* message, message);
+    }
+
+    void tcp_server::connection::queue(const int file_descriptor, const off_t offset, const size_t length, const std::shared_ptr<const void> owner) {
+        if (length)
+            this->_queue.push_back({ "", file_descriptor, length, offset, owner });
+    }
+
+    bool tcp_server::connection::_read() {
+        while (true) {
+            std::span<char> space = this->_buffer.prepare();
+
+            // Stop at capacity; the rest waits in the socket
+            if (space.empty())
+                return true;
+
+            ssize_t len = ::recv(this->_file_descriptor, space.data(), space.size(), 0);
+
+            if (len > 0) {
+                this->_buffer.commit(len);
+
+                continue;
+            }
+
+            // Idle connections hold no storage
+            if (this->_buffer.empty())
+                this->_buffer.clear();
+
+            if (len == 0)
+                return false;
+
+            if (errno == EINTR)
+                continue;
+
+            // Drained; edge-triggered readiness fires again on new bytes
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return true;
+
+            throw mysocket::error(errno);
+        }
+    }
+
+    bool tcp_client::readable() const {
+        return _wait(this->_file_descriptor, POLLIN, std::chrono::steady_clock::now());
+    }
+
+#ifdef __linux__
+    void tcp_server::_receive(class connection* connection) {
+        connection->_ring->recv(connection->_file_descriptor, [this, connection](const int result, const uint32_t flags) {
+            if (result > 0) {
+                std::string_view data = connection->_ring->buffer(result, flags);
+
+                // What doesn't fit waits for the handler to consume; closing connections discard what arrives
+                while (data.length() && !connection->_closing && !connection->_released) {
+                    data.remove_prefix(connection->_buffer.append(data));
+
+                    try {
+                        this->_received(connection);
+                    } catch (mysocket::error& e) {
+                        this->_release(connection, false);
+
+                        break;
+                    }
+
+                    // Unless the handler made room, the request can't fit
+                    if (data.length() && connection->_buffer.full() && !connection->_closing) {
+                        this->_overflow(connection);
+
+                        break;
+                    }
+                }
+
+                connection->_ring->recycle(flags);
+
+                if (connection->_released)
+                    return;
+            } else if (result == 0)
+                // Peer closed its end; answer what it sent, then close ours
+                return this->_release(connection, true);
+            else if (result != -ENOBUFS)
+                return this->_release(connection, false);
+
+            // Out of provided buffers, or otherwise stopped; rearm
+            if (!(flags & IORING_CQE_F_MORE))
+                this->_receive(connection);
+        });
+    }
+
+#endif
+    tcp_server::connection* tcp_server::registry::remove(const uint64_t handle) {
+        uint32_t index = (uint32_t) handle,
+                 generation = (uint32_t) (handle >> 32);
+        slot*    slot = this->_slot(index);
+
+        // Only one remover advances the generation
+        if (!slot || !slot->generation.compare_exchange_strong(generation, generation + 1, std::memory_order_acq_rel))
+            return NULL;
+
+        class connection* result = slot->connection.exchange(NULL, std::memory_order_acq_rel);
+        uint64_t          head = this->_free.load(std::memory_order_acquire),
+                          next;
+
+        do {
+            slot->next.store((uint32_t) head, std::memory_order_relaxed);
+
+            // Count the push in the tag
+            next = (((head >> 32) + 1) << 32) | (index + 1);
+        } while (!this->_free.compare_exchange_weak(head, next, std::memory_order_acq_rel));
+
+        return result;
+    }
+
+    void tcp_server::_open(const struct sockaddr* address, const socklen_t length) {
+        std::vector<int> listeners;
+
+        try {
+            // Group members are indexed in bind order, so loop i owns listener i
+            for (size_t i = 0; i < (this->_options.reuse_port ? std::max(this->_options.loops, (size_t) 1) : 1); i++)
+                listeners.push_back(_bind(address, length, this->_options.backlog, this->_options.reuse_port));
+        } catch (mysocket::error& e) {
+            for (int listener: listeners)
+                ::close(listener);
+
+            throw e;
+        }
+
+        this->_start(listeners);
+    }
+
+    void tcp_server::_overflow(class connection* connection) {
+        if (this->_options.overflow) {
+            this->_options.overflow(connection);
+
+            connection->flush();
+        }
+
+        this->_release(connection, true);
+    }
+
+    tcp_server::connection::awaiter tcp_server::connection::read() {
+        return { this, false, &this->_reader };
+    }
+
+    void tcp_server::_release(class connection* connection, const bool drain) {
+        // Already released
+        if (this->_connections.find(connection->_id) != connection)
+            return;
+
+        if (drain && (!connection->_queue.empty() || connection->_held)) {
+            connection->_closing = true;
+
+            return;
+        }
+
+        // While it still exists
+        connection->_released = true;
+        connection->_resume(connection->_reader);
+        connection->_resume(connection->_writer);
+
+        event_loop* loop = this->_loops[connection->_loop].get();
+
+        loop->reactor.timers().cancel(connection->_timer);
+        loop->connections.erase(connection);
+
+#ifdef __linux__
+        if (connection->_ring) {
+            // Sends in flight still read its buffers, and the kernel its descriptor; free it once they're done
+            if (this->_connections.remove(connection->_id) == connection)
+                connection->_ring->cancel(connection->_file_descriptor, [connection]() {
+                    try {
+                        connection->_close();
+                    } catch (mysocket::error& e) {
+                        // Already closed by the peer
+                    }
+                });
+
+            return;
+        }
+#endif
+        loop->reactor.remove(connection->_watch);
+
+        try {
+            this->close(connection);
+        } catch (mysocket::error& e) {
+            // Already closed by the peer
+        }
+    }
+
+    void tcp_server::_received(class connection* connection) {
+        // A coroutine awaiting read() takes the bytes instead
+        if (connection->_reader)
+            return connection->_resume(connection->_reader);
+
+        this->_handler(connection);
+    }
+
+    void tcp_server::connection::_resume(std::coroutine_handle<>& waiter) {
+        std::coroutine_handle<> handle = waiter;
+
+        waiter = nullptr;
+
+        if (handle)
+            handle.resume();
+    }
+
+    tcp_server::registry::slot* tcp_server::registry::_slot(const uint32_t index) const {
+        if (index >= _chunk_size * std::size(this->_chunks))
+            return NULL;
+
+        slot* chunk = this->_chunks[index / _chunk_size].load(std::memory_order_acquire);
+
+        return chunk ? &chunk[index % _chunk_size] : NULL;
+    }
+
+    void tcp_server::_serve(class connection* connection) {
+        event_loop* loop = this->_loops[connection->_loop].get();
+
+        connection->_timer.function = [this, connection]() {
+            // Still sending to a peer that's reading, however slowly
+            if (!connection->_queue.empty() && connection->_progress)
+                return connection->timeout(connection->_timeout);
+
+            this->_release(connection, false);
+        };
+
+        connection->timeout(this->_options.timeout);
+
+        loop->connections.insert(connection);
+
+        // Accepted before draining began; let the peer retry elsewhere
+        if (loop->draining)
+            return this->_release(connection, false);
+
+#ifdef __linux__
+        if (connection->_ring)
+            return this->_receive(connection);
+#endif
+        connection->_watch = loop->reactor.add(connection->_file_descriptor, reactor::READ, [this, connection](const int events) {
+            try {
+                if (events & reactor::WRITE) {
+                    connection->flush();
+
+                    if (connection->_queue.empty())
+                        connection->_resume(connection->_writer);
+
+                    if (connection->_closing && connection->_queue.empty())
+                        return this->_release(connection, true);
+                }
+
+                if (!(events & reactor::READ) || connection->_closing)
+                    return;
+
+                while (true) {
+                    size_t length = connection->_buffer.length();
+                    bool   open = connection->_read();
+
+                    // Reading stopped at capacity, with more perhaps left in the socket
+                    bool   full = connection->_buffer.full();
+
+                    if (connection->_buffer.length() > length)
+                        this->_received(connection);
+
+                    // Peer closed its end; answer what it sent, then close ours
+                    if (!open)
+                        return this->_release(connection, true);
+
+                    if (!full || connection->_closing)
+                        return;
+
+                    // Unless the handler made room, the request can't fit
+                    if (connection->_buffer.full())
+                        return this->_overflow(connection);
+                }
+            } catch (mysocket::error& e) {
+                this->_release(connection, false);
+            }
+        });
+    }
+
+    void tcp_server::_start(const std::vector<int>& listeners) {
+        // Each member of a group takes its share of connections, so needs its own loop
+        size_t nloops = listeners.size() > 1 ? listeners.size() : std::max(this->_options.loops, (size_t) 1),
+               nlisteners = listeners.size();
+
+        this->_options.reuse_port = nlisteners > 1;
+
+        for (size_t i = 0; i < nloops; i++) {
+            this->_loops.push_back(std::make_unique<event_loop>());
+            this->_loops[i]->listener = listeners[i < nlisteners ? i : 0];
+        }
+
+        this->_file_descriptor = this->_loops[0]->listener;
+
+#ifdef __linux__
+        if (this->_options.reuse_port && this->_options.steer) {
+            // Return the receiving CPU; out-of-range indices fall back to hashing
+            struct sock_filter code[] = {
+                { BPF_LD | BPF_W | BPF_ABS, 0, 0, (uint32_t) (SKF_AD_OFF + SKF_AD_CPU) },
+                { BPF_RET | BPF_A, 0, 0, 0 }
+            };
+            struct sock_fprog  program = { sizeof(code) / sizeof(code[0]), code };
+
+            // Applies to the whole group; steering is an optimization, so failure is ignored
+            setsockopt(this->_file_descriptor, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program));
+        }
+
+        if (this->_options.io_uring && uring::supported()) {
+            // Every loop accepts for itself
+            for (size_t i = 0; i < this->_loops.size(); i++) {
+                this->_loops[i]->ring = std::make_unique<uring>(this->_loops[i]->reactor);
+                this->_listen(i);
+            }
+        } else
+#endif
+        for (size_t i = 0; i < nlisteners; i++) {
+            // Unless reuse_port, the first loop accepts for all
+            this->_loops[i]->watch = this->_loops[i]->reactor.add(this->_loops[i]->listener, reactor::READ, [this, i](const int) {
+                this->_accept(i);
+            });
+        }
+
+        for (size_t i = 0; i < this->_loops.size(); i++) {
+            event_loop* loop = this->_loops[i].get();
+
+            loop->thread = std::thread([this, loop]() {
+#ifdef __linux__
+                if (loop->ring)
+                    return loop->ring->run();
+#endif
+                loop->reactor.run();
+            });
+
+#ifdef __linux__
+            if (this->_options.reuse_port && this->_options.steer) {
+                cpu_set_t cpus;
+
+                CPU_ZERO(&cpus);
+                CPU_SET(i % std::max(std::thread::hardware_concurrency(), 1u), &cpus);
+
+                pthread_setaffinity_np(loop->thread.native_handle(), sizeof(cpus), &cpus);
+            }
+#endif
+        }
+    }
+
+#ifdef __linux__
+    void tcp_server::connection::_sent(const int result) {
+        size_t len = std::max(result, 0);
+
+        // Pop segments sent in full, then trim the one sent in part
+        while (len && len >= this->_queue.front().data.length()) {
+            len -= this->_queue.front().data.length();
+
+            this->_queue.pop_front();
+        }
+
+        if (len)
+            this->_queue.front().data.remove_prefix(len);
+
+        if (result > 0)
+            this->_progress = true;
+
+        this->_sending = false;
+
+        if (result < 0)
+            return this->_parent->_release(this, false);
+
+        // Send what's left, including any part not sent
+        this->_submit();
+    }
+
+    void tcp_server::connection::_submit() {
+        // Released, perhaps by an earlier call; freed once its operations finish
+        if (this->_sending || this->_released)
+            return;
+
+        // Files are sent in place
+        try {
+            if (this->_write(false, false))
+                this->_progress = true;
+        } catch (mysocket::error& e) {
+            return this->_parent->_release(this, false);
+        }
+
+        if (this->_queue.empty()) {
+            // It may queue more
+            this->_resume(this->_writer);
+
+            if (this->_closing && this->_queue.empty() && !this->_sending)
+                this->_parent->_release(this, true);
+
+            return;
+        }
+
+        if (this->_queue.front().file_descriptor != -1) {
+            this->_sending = true;
+
+            // Resume when writable
+            this->_ring->poll(this->_file_descriptor, POLLOUT, [this](const int result, const uint32_t) {
+                this->_sending = false;
+
+                if (result < 0)
+                    return this->_parent->_release(this, false);
+
+                this->_submit();
+            });
+
+            return;
+        }
+
+        // Kept until the send completes, even if the connection is released first
+        struct batch {
+            std::vector<struct iovec>                 iov;
+            struct msghdr                             message;
+            std::vector<std::shared_ptr<const void>>  owners;
+        };
+
+        std::shared_ptr<batch> batch = std::make_shared<struct batch>();
+
+        // Gather memory segments preceding the next file. One send at a time; a short send is a success, so a later
+        // one mustn't start until the rest of it is sent
+        for (size_t i = 0; i < this->_queue.size() && batch->iov.size() < IOV_MAX && this->_queue[i].file_descriptor == -1; i++) {
+            batch->iov.push_back({ (void *) this->_queue[i].data.data(), this->_queue[i].data.length() });
+            batch->owners.push_back(this->_queue[i].owner);
+        }
+
+        memset(&batch->message, 0, sizeof(batch->message));
+
+        batch->message.msg_iov = batch->iov.data();
+        batch->message.msg_iovlen = batch->iov.size();
+
+        this->_sending = true;
+
+        this->_ring->sendmsg(this->_file_descriptor, &batch->message, [this, batch](const int result, const uint32_t) {
+            this->_sent(result);
+        });
+    }
+
+#endif
+    size_t udp_socket::arena::size() const {
+        return this->_size;
+    }
+
+    void tcp_server::connection::timeout(const std::chrono::milliseconds duration) {
+        if (!this->_reactor || this->_released)
+            return;
+
+        this->_progress = false;
+        this->_timeout = duration;
+
+        if (duration == std::chrono::milliseconds::max())
+            return this->_reactor->timers().cancel(this->_timer);
+
+        this->_reactor->timers().arm(this->_timer, duration);
+    }
+
+    tcp_server::connection::awaiter tcp_server::connection::write(const std::shared_ptr<const std::string> message) {
+        if (this->_released)
+            return { this, true, &this->_writer };
+
+        if (message)
+            this->queue(message);
+
+        this->flush();
+
+        bool sent = this->_queue.empty();
+
+#ifdef __linux__
+        sent = sent && !this->_sending;
+#endif
+        return { this, sent, &this->_writer };
+    }
+
+    size_t tcp_server::connection::_write(const bool more, const bool gather) {
+        size_t result = 0;
+
+        while (!this->_queue.empty()) {
+            segment& front = this->_queue.front();
+
+            if (front.file_descriptor != -1) {
+#ifdef __linux__
+                ssize_t len = ::sendfile(this->_file_descriptor, front.file_descriptor, &front.offset, front.length);
+
+                if (len == -1) {
+                    if (errno == EINTR)
+                        continue;
+
+                    if (errno == EAGAIN || errno == EWOULDBLOCK)
+                        return result;
+
+                    throw mysocket::error(errno);
+                }
+
+                front.length -= len;
+                result += len;
+#else
+                off_t len = front.length;
+
+                // Bytes may have been sent before an interruption
+                int status = ::sendfile(front.file_descriptor, this->_file_descriptor, front.offset, &len, NULL, 0);
+
+                if (status == -1 && errno != EINTR && errno != EAGAIN)
+                    throw mysocket::error(errno);
+
+                front.offset += len;
+                front.length -= len;
+                result += len;
+
+                if (status == -1) {
+                    if (errno == EAGAIN)
+                        return result;
+
+                    continue;
+                }
+#endif
+                // Truncated since its length was announced; the response can't be completed, so the peer must see
+                // the connection close
+                if (!len && front.length)
+                    throw mysocket::error(EIO);
+
+                if (!front.length)
+                    this->_queue.pop_front();
+
+                continue;
+            }
+
+            if (!gather)
+                return result;
+
+            // Gather memory segments preceding the next file
+            std::vector<struct iovec> iov;
+
+            for (size_t i = 0; i < this->_queue.size() && iov.size() < IOV_MAX && this->_queue[i].file_descriptor == -1; i++)
+                iov.push_back({ (void *) this->_queue[i].data.data(), this->_queue[i].data.length() });
+
+            struct msghdr msg;
+
+            memset(&msg, 0, sizeof(msg));
+
+            msg.msg_iov = iov.data();
+            msg.msg_iovlen = iov.size();
+
+            // Announce more data if a file, or the caller's, follows
+            bool    follows = iov.size() < this->_queue.size() || more;
+            ssize_t len = sendmsg(this->_file_descriptor, &msg, MSG_NOSIGNAL | (follows ? MSG_MORE : 0));
+
+            if (len == -1) {
+                if (errno == EINTR)
+                    continue;
+
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    return result;
+
+                throw mysocket::error(errno);
+            }
+
+            result += len;
+
+            // Pop segments sent in full, then trim the one sent in part
+            while (!this->_queue.empty() && this->_queue.front().file_descriptor == -1 && (size_t) len >= this->_queue.front().data.length()) {
+                len -= this->_queue.front().data.length();
+
+                this->_queue.pop_front();
+            }
+
+            if (len)
+                this->_queue.front().data.remove_prefix(len);
+        }
+
+        return result;
+    }
+
+    void tcp_client::close() {
+        if (::close(this->_file_descriptor)) 
+            throw mysocket::error(errno);
+
+        delete this;
+    }
+
+    void tcp_server::close() {
+        this->_shut_down.store(true);
+
+        for (std::unique_ptr<event_loop>& loop: this->_loops) {
+#ifdef __linux__
+            if (loop->ring) {
+                loop->ring->stop();
+
+                continue;
+            }
+#endif
+            loop->reactor.stop();
+        }
+
+        for (std::unique_ptr<event_loop>& loop: this->_loops)
+            loop->thread.join();
+
+        for (std::unique_ptr<event_loop>& loop: this->_loops)
+            if (loop->listener != this->_file_descriptor)
+                ::close(loop->listener);
+
+        if (::close(this->_file_descriptor))
+            throw mysocket::error(errno);
+
+        // Abstract names vanish with their socket
+        if (this->_path.length() && this->_path[0] != '@')
+            unlink(this->_path.c_str());
+
+        if (this->_listener.joinable())
+            this->_listener.join();
+
+        int errnum = 0;
+
+        this->_connections.for_each([this, &errnum](class connection* connection) {
+            if (!this->_connections.remove(connection->_id))
+                return;
+
+            try {
+                connection->_close();
+            } catch (mysocket::error& e) {
+                errnum = e.errnum();
+            }
+        });
+
+        if (errnum)
+            throw mysocket::error(errnum);
+
+        delete this;
+    }
+
+    void udp_socket::close() {
+        if (::close(this->_file_descriptor))
+            throw mysocket::error(errno);
+        
+        delete this->_address;
+        delete this;
+    }
+
+    void tcp_server::close(class connection* connection) {
+        // Whoever removes it closes it
+        if (this->_connections.remove(connection->_id) == connection)
+            connection->_close();
+    }
+
+    std::vector<tcp_server::connection*> tcp_server::connections() {
+        std::vector<connection*> result;
+
+        this->_connections.for_each([&result](class connection* connection) {
+            result.push_back(connection);
+        });
+
+        return result;
+    }
+
+    void tcp_server::connections(const std::function<void(connection*)> function) const {
+        this->_connections.for_each(function);
+    }
+
+    int error::errnum() const {
+        return this->_errnum;
+    }
+
+    std::string tcp_server::connection::recv() const {
+        return _recv(this->_file_descriptor);
+    }
+
+    size_t tcp_server::connection::recv(std::string& buffer) const {
+        return _recv(this->_file_descriptor, buffer);
+    }
+
+    std::string tcp_client::recv() const {
+        return _recv(this->_file_descriptor);
+    }
+
+    size_t tcp_client::recv(std::string& buffer, const std::chrono::milliseconds timeout) const {
+        if (!_wait(this->_file_descriptor, POLLIN, _deadline(timeout)))
+            throw mysocket::error(ETIMEDOUT);
+
+        return _recv(this->_file_descriptor, buffer);
+    }
+
+    std::string udp_socket::recvfrom() const {
+        char      buff[1024];
+        socklen_t addrlen = sizeof(* this->_address);
+        ssize_t   len = ::recvfrom(this->_file_descriptor, (char *)buff, 1024, MSG_WAITALL, (struct sockaddr *)this->_address, &addrlen);
+        
+        if (len == -1)
+            throw mysocket::error(errno);
+        
+        return std::string(buff, strnlen(buff, len));
+    }
+
+    size_t udp_socket::recvmmsg(arena& arena, const bool wait) const {
+        // The kernel overwrites lengths on each receive
+        for (size_t i = 0; i < arena.capacity(); i++) {
+            struct msghdr& header = arena._messages[i].msg_hdr;
+
+            arena._iov[i].iov_len = arena._message_size;
+
+            header.msg_namelen = sizeof(struct sockaddr_in);
+            header.msg_controllen = _control_size;
+            header.msg_flags = 0;
+        }
+
+        size_t n = 0;
+
+#ifdef __linux__
+        int len = ::recvmmsg(this->_file_descriptor, arena._messages.data(), (unsigned) arena.capacity(), wait ? MSG_WAITFORONE : MSG_DONTWAIT, NULL);
+
+        if (len == -1) {
+            if (wait || (errno != EAGAIN && errno != EWOULDBLOCK))
+                throw mysocket::error(errno);
+        } else
+            n = len;
+#else
+        while (n < arena.capacity()) {
+            ssize_t len = ::recvmsg(this->_file_descriptor, &arena._messages[n].msg_hdr, wait && !n ? 0 : MSG_DONTWAIT);
+
+            if (len == -1) {
+                // Keep what arrived
+                if (n || (!wait && (errno == EAGAIN || errno == EWOULDBLOCK)))
+                    break;
+
+                throw mysocket::error(errno);
+            }
+
+            arena._messages[n++].msg_len = (unsigned) len;
+        }
+#endif
+        arena._size = n;
+
+        for (size_t i = 0; i < n; i++) {
+            datagram& datagram = arena._datagrams[i];
+
+            datagram.address = arena._names[i];
+            datagram.data = std::string_view(&arena._buffers[i * arena._message_size], arena._messages[i].msg_len);
+            datagram.segment_size = 0;
+
+#ifdef __linux__
+            struct msghdr* header = &arena._messages[i].msg_hdr;
+
+            for (struct cmsghdr* control = CMSG_FIRSTHDR(header); control; control = CMSG_NXTHDR(header, control))
+                if (control->cmsg_level == SOL_UDP && control->cmsg_type == UDP_GRO) {
+                    int size;
+
+                    memcpy(&size, CMSG_DATA(control), sizeof(size));
+
+                    datagram.segment_size = (uint16_t) size;
+                }
+#endif
+        }
+
+        return n;
+    }
+
+    int tcp_server::connection::send(const std::string& message) const {
+        return _send(this->_file_descriptor, message);
+    }
+
+    int tcp_server::connection::send(const std::vector<std::string_view>& messages) const {
+        return (int) _send(this->_file_descriptor, messages);
+    }
+
+    size_t tcp_server::connection::sendfile(const int file_descriptor, const off_t offset, const size_t length) const {
+        return _sendfile(this->_file_descriptor, file_descriptor, offset, length);
+    }
+
+    int tcp_client::send(const std::string& message) const {
+        return _send(this->_file_descriptor, message);
+    }
+
+    void tcp_client::send(const std::string_view message, const std::chrono::milliseconds timeout) const {
+        std::chrono::steady_clock::time_point deadline = _deadline(timeout);
+        size_t                                sent = 0;
+
+        while (sent < message.length()) {
+            if (!_wait(this->_file_descriptor, POLLOUT, deadline))
+                throw mysocket::error(ETIMEDOUT);
+
+            ssize_t len = ::send(this->_file_descriptor, message.data() + sent, message.length() - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+            if (len == -1) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                    continue;
+
+                throw mysocket::error(errno);
+            }
+
+            sent += len;
+        }
+    }
+
+    size_t udp_socket::sendmmsg(const std::span<const datagram> datagrams) const {
+        constexpr size_t batch = 64;
+
+        size_t result = 0;
+
+        while (result < datagrams.size()) {
+            size_t         n = std::min(batch, datagrams.size() - result);
+            struct mmsghdr messages[batch];
+            struct iovec   iov[batch];
+#ifdef __linux__
+
+            alignas(struct cmsghdr) char controls[batch][_control_size];
+#endif
+
+            memset(messages, 0, sizeof(messages[0]) * n);
+
+            for (size_t i = 0; i < n; i++) {
+                const datagram& datagram = datagrams[result + i];
+                struct msghdr&  header = messages[i].msg_hdr;
+
+                iov[i] = { (void *) datagram.data.data(), datagram.data.length() };
+
+                header.msg_name = (void *) (datagram.address.sin_family ? &datagram.address : this->_address);
+                header.msg_namelen = sizeof(struct sockaddr_in);
+                header.msg_iov = &iov[i];
+                header.msg_iovlen = 1;
+
+#ifdef __linux__
+                if (!datagram.segment_size)
+                    continue;
+
+                header.msg_control = controls[i];
+                header.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+
+                struct cmsghdr* control = CMSG_FIRSTHDR(&header);
+
+                control->cmsg_level = SOL_UDP;
+                control->cmsg_type = UDP_SEGMENT;
+                control->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+
+                memcpy(CMSG_DATA(control), &datagram.segment_size, sizeof(uint16_t));
+#endif
+            }
+
+#ifdef __linux__
+            int len = ::sendmmsg(this->_file_descriptor, messages, (unsigned) n, 0);
+
+            // Report what was sent before the failure
+            if (len == -1) {
+                if (result)
+                    return result;
+
+                throw mysocket::error(errno);
+            }
+
+            result += len;
+#else
+            for (size_t i = 0; i < n; i++) {
+                const datagram&  datagram = datagrams[result];
+                std::string_view data = datagram.data;
+
+                // Split segments here, without UDP_SEGMENT
+                do {
+                    size_t length = datagram.segment_size ? std::min(data.length(), (size_t) datagram.segment_size) : data.length();
+
+                    iov[i] = { (void *) data.data(), length };
+
+                    if (::sendmsg(this->_file_descriptor, &messages[i].msg_hdr, 0) == -1) {
+                        if (result)
+                            return result;
+
+                        throw mysocket::error(errno);
+                    }
+
+                    data.remove_prefix(length);
+                } while (data.length());
+
+                result++;
+            }
+#endif
+        }
+
+        return result;
+    }
+
+    int udp_socket::sendto(const std::string message) const {
+        ssize_t len = ::sendto(this->_file_descriptor, (const char *)message.c_str(), message.length(), 0, (const struct sockaddr *)this->_address, sizeof(* this->_address));
+        
+        if (len == -1)
+            throw mysocket::error(errno);
+        
+        return (int) len;
+    }
+
+    const udp_socket::datagram& udp_socket::arena::operator[](const size_t index) const {
+        return this->_datagrams[index];
     }
 
     const char* error::what() const throw() {
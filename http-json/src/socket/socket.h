@@ -8,15 +8,53 @@
 #ifndef socket_h
 #define socket_h
 
+#include "input_buffer.h"
+#include "reactor.h"
+#include "uring.h"
 #include "util.h"
+#include <algorithm>
 #include <arpa/inet.h>  // inet_ptons
+#include <chrono>
+#include <climits>      // IOV_MAX
+#include <coroutine>
+#include <cstddef>      // offsetof
 #include <csignal>      // signal
+#include <deque>
+#include <fcntl.h>      // fcntl
+#include <memory>
 #include <mutex>
 #include <netinet/in.h> // sockaddr_in
+#include <netinet/tcp.h> // TCP_CORK, TCP_NOPUSH
+#include <poll.h>       // poll
+#include <span>
+#include <string_view>
 #include <sys/socket.h> // socket
+#include <sys/stat.h>   // stat
+#ifdef __linux__
+#include <linux/filter.h> // sock_fprog
+#include <netinet/udp.h>  // UDP_GRO, UDP_SEGMENT
+#include <pthread.h>      // pthread_setaffinity_np
+#include <sys/sendfile.h>
+#endif
+#include <sys/uio.h>    // iovec
+#include <sys/un.h>     // sockaddr_un
 #include <thread>
+#include <unordered_set>
 #include <unistd.h>     // close, read
 
+// Linux-only; elsewhere, cork() batches segments instead
+#ifndef MSG_MORE
+#define MSG_MORE 0
+#endif
+
+// Linux's recvmmsg and sendmmsg entry; elsewhere, batches loop over recvmsg and sendmsg
+#ifndef __linux__
+struct mmsghdr {
+    struct msghdr msg_hdr;
+    unsigned int  msg_len;
+};
+#endif
+
 namespace mysocket {
     // Typedef
     
@@ -40,15 +78,40 @@ namespace mysocket {
     struct tcp_client {
         // Constructors
 
-        tcp_client(const std::string host, const int port);
+        /**
+         * Connect to host, an IPv4 address, within timeout; throw mysocket::error(ETIMEDOUT) if it elapses
+         */
+        tcp_client(const std::string host, const int port, const std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+        /**
+         * Connect to the Unix-domain stream socket at path; a leading '@' names one in Linux's abstract namespace
+         */
+        tcp_client(const std::string path);
 
         // Member Functions
 
         void        close();
 
+        /**
+         * Return true if bytes, or end-of-stream, wait to be received; an idle keep-alive connection that's readable
+         * was closed by its peer
+         */
+        bool        readable() const;
+
         std::string recv() const;
 
-        int         send(const std::string message) const;
+        /**
+         * Wait up to timeout for bytes, append those available to buffer, and return their number; 0 at end-of-stream.
+         * Throw mysocket::error(ETIMEDOUT) if none arrive
+         */
+        size_t      recv(std::string& buffer, const std::chrono::milliseconds timeout) const;
+
+        int         send(const std::string& message) const;
+
+        /**
+         * Send all of message within timeout; throw mysocket::error(ETIMEDOUT) if it elapses
+         */
+        void        send(const std::string_view message, const std::chrono::milliseconds timeout) const;
     private:
         // Constructors
 
@@ -64,6 +127,22 @@ namespace mysocket {
         // Typedef
 
         class connection {
+            // Typedef
+
+            struct segment {
+                // Member Fields
+
+                std::string_view            data;
+
+                // File sent after data, if any
+                int                         file_descriptor = -1;
+                size_t                      length = 0;
+                off_t                       offset = 0;
+
+                // Keeps data or the file alive until sent
+                std::shared_ptr<const void> owner;
+            };
+
             // Constructors
 
             connection(tcp_server* parent, const int file_descriptor);
@@ -72,24 +151,257 @@ namespace mysocket {
 
             // Member Fields
 
-            int         _file_descriptor;
-            tcp_server* _parent = NULL;
+            // Bytes received but not yet consumed
+            input_buffer                          _buffer;
+            bool                                  _closing = false;
+            std::shared_ptr<void>                 _context;
+            int                                   _file_descriptor;
+
+            // Tasks held by hold() and not yet run
+            size_t                                _held = 0;
+
+            // Handle in the server's registry
+            uint64_t                              _id = 0;
+
+            // Expires when the connection is deleted
+            std::shared_ptr<bool>                 _lifetime = std::make_shared<bool>(true);
+
+            // Index of the event loop serving this connection, if any
+            size_t                                _loop = 0;
+            tcp_server*                           _parent = NULL;
+
+            // Bytes sent since the timer was armed
+            bool                                  _progress = false;
+
+            // Segments awaiting flush
+            std::deque<segment>                   _queue;
+            class reactor*                        _reactor = NULL;
+
+            // Coroutine awaiting read(), if any
+            std::coroutine_handle<>               _reader;
+
+            // Released; awaiting coroutines resume to find it closed
+            bool                                  _released = false;
+
+            // Duration the timer was last armed for
+            std::chrono::milliseconds             _timeout = std::chrono::milliseconds::max();
+
+            // Closes the connection once idle, on its loop's timers; not while sends progress
+            timer_wheel::timer                    _timer;
+            uint64_t                              _watch = 0;
+
+            // Coroutine awaiting write(), if any
+            std::coroutine_handle<>               _writer;
+#ifdef __linux__
+
+            // Whether a send or poll is in flight, in io_uring mode
+            class uring*                          _ring = NULL;
+            bool                                  _sending = false;
+#endif
 
             // Member Functions
 
-            void _close();
+            void   _close();
+
+            /**
+             * Append available bytes to the buffer; return false if the peer closed the connection
+             */
+            bool   _read();
+
+            /**
+             * Resume the coroutine waiting in waiter, if any
+             */
+            void   _resume(std::coroutine_handle<>& waiter);
+
+#ifdef __linux__
+            /**
+             * Account for a completed send, and submit what remains once none are in flight
+             */
+            void   _sent(const int result);
+
+            /**
+             * Submit queued segments to the ring, unless sends are in flight
+             */
+            void   _submit();
+#endif
+
+            /**
+             * Write queued segments until done or the socket would block, and return the number of bytes written; if
+             * not gather, stop at the first segment in memory
+             */
+            size_t _write(const bool more = false, const bool gather = true);
         public:
             // Typdef
 
             friend tcp_server;
 
+            struct credentials {
+                // Member Fields
+
+                pid_t pid;
+                uid_t uid;
+                gid_t gid;
+            };
+
+            /**
+             * Resumes a coroutine on the connection's loop; see read() and write()
+             */
+            struct awaiter {
+                // Member Fields
+
+                class connection*        connection;
+                bool                     ready;
+                std::coroutine_handle<>* waiter;
+
+                // Member Functions
+
+                bool await_ready() const;
+
+                void await_suspend(const std::coroutine_handle<> handle) const;
+
+                /**
+                 * Return false if the connection closed; it's gone once the coroutine next suspends
+                 */
+                bool await_resume() const;
+            };
+
             // Member Functions
 
-            void        close();
+            /**
+             * Return bytes received but not yet consumed, valid until the next consume() or receive; event-loop mode
+             * only
+             */
+            std::string_view       buffer() const;
+
+            /**
+             * Close the connection; in event-loop mode, queued segments are sent first, and this may be called from any
+             * thread
+             */
+            void                   close();
+
+            /**
+             * Drop length bytes from the front of buffer(), once handled; event-loop mode only
+             */
+            void                   consume(const size_t length);
+
+            /**
+             * Return handler-owned state, destroyed with the connection
+             */
+            std::shared_ptr<void>& context();
+
+            /**
+             * Hold partial segments until uncorked, so that subsequent sends fill packets
+             */
+            void                   cork(const bool value) const;
+
+            /**
+             * Return the peer process's credentials as of connect (SO_PEERCRED); Unix-domain connections only
+             */
+            struct credentials     credentials() const;
+
+            /**
+             * Send queued segments in order, in as few system calls as possible, retrying partial writes, and return
+             * the number of bytes sent; if more, more data follows immediately. In event-loop mode, segments the
+             * socket can't yet accept are sent when it becomes writable; with io_uring, all sends complete later and
+             * 0 is returned
+             */
+            size_t                 flush(const bool more = false);
+
+            /**
+             * Return a function, to be called once from any thread, that runs a task on the connection's loop unless
+             * the connection is released first; until it's called, closing waits as it does for queued segments.
+             * Event-loop mode only
+             */
+            std::function<void(const std::function<void()> task)> hold();
+
+            /**
+             * Return a token that expires when the connection is deleted; a coroutine that awaits anything but read()
+             * and write() checks it before touching the connection again
+             */
+            std::weak_ptr<bool>    lifetime() const;
+
+            /**
+             * Queue message to be sent on flush; owner keeps message's bytes alive until then
+             */
+            void                   queue(const std::string_view message, const std::shared_ptr<const void> owner = nullptr);
+
+            void                   queue(const std::shared_ptr<const std::string> message);
+
+            /**
+             * Queue length bytes of file_descriptor, starting at offset, to be sent without copying them through user
+             * space; owner keeps file_descriptor open until then
+             */
+            void                   queue(const int file_descriptor, const off_t offset, const size_t length, const std::shared_ptr<const void> owner);
+
+            /**
+             * Return an awaitable that resumes, on the connection's loop, once more bytes are in buffer(), or once the
+             * connection closes; while a coroutine awaits it, arrivals resume the coroutine instead of calling the
+             * handler. Event-loop mode only, on the connection's loop
+             */
+            awaiter                read();
+
+            std::string            recv() const;
+
+            /**
+             * Append received bytes to buffer and return their number; 0 if the peer closed the connection
+             */
+            size_t                 recv(std::string& buffer) const;
+
+            int                    send(const std::string& message) const;
+
+            /**
+             * Send messages in order, in as few system calls as possible
+             */
+            int                    send(const std::vector<std::string_view>& messages) const;
+
+            /**
+             * Send length bytes of file_descriptor, starting at offset, without copying them through user space
+             */
+            size_t                 sendfile(const int file_descriptor, const off_t offset, const size_t length) const;
+
+            /**
+             * Close the connection if duration passes before the next call, to the millisecond, unless segments are
+             * still queued and some were sent meanwhile; the deadline then restarts. Event-loop mode only, on the
+             * connection's loop
+             */
+            void                   timeout(const std::chrono::milliseconds duration);
+
+            /**
+             * Queue message, if any, and flush; return an awaitable that resumes, on the connection's loop, once every
+             * queued segment is sent, or once the connection closes. Event-loop mode only, on the connection's loop
+             */
+            awaiter                write(const std::shared_ptr<const std::string> message = nullptr);
+        };
+
+        struct options {
+            // Member Fields
+
+            int                              backlog = 1024;
 
-            std::string recv() const;
+            // Most bytes held unconsumed per connection; a connection that reaches it without consuming is closed
+            size_t                           buffer_capacity = 1 << 20;
 
-            int         send(const std::string message) const;
+            // Number of event-loop threads
+            size_t                           loops = std::max(std::thread::hardware_concurrency(), 1u);
+
+            // Called on a connection's loop once it reaches buffer_capacity without consuming; what it queues, such as
+            // an error reply, is sent before the connection closes
+            std::function<void(connection*)> overflow;
+
+            // Close connections idle this long after accept, until the handler sets its own timeout
+            std::chrono::milliseconds        timeout = std::chrono::milliseconds::max();
+
+            // Accept, receive, and send through io_uring where the kernel supports it (Linux 6.0+), otherwise fall
+            // back to readiness events
+            bool                             io_uring = false;
+
+            // Give each loop its own listener on the same port, with SO_REUSEPORT, so accepts don't serialize on one
+            // socket; Linux only, elsewhere one listener is shared
+            bool                             reuse_port = false;
+
+            // With reuse_port, pin loop i to CPU i and hand each connection to the listener of the CPU that received
+            // it; best with one loop per CPU
+            bool                             steer = false;
         };
 
         // Constructors
@@ -98,6 +410,26 @@ namespace mysocket {
 
         tcp_server(const int port, const std::function<void(connection*)> handler, const int backlog = 1024);
 
+        /**
+         * Serve connections on a fixed number of event-loop threads; handler is called on a connection's loop each
+         * time it receives bytes, and must not block
+         */
+        tcp_server(const int port, const std::function<void(connection*)> handler, const struct options options);
+
+        /**
+         * Serve connections on the Unix-domain stream socket at path, as above; a leading '@' names one in Linux's
+         * abstract namespace. A stale socket file is replaced, and the file is removed on close. reuse_port doesn't
+         * apply
+         */
+        tcp_server(const std::string path, const std::function<void(connection*)> handler, const struct options options);
+
+        /**
+         * Serve connections on listeners already bound and listening, as above, e.g. handed over by a predecessor;
+         * loop i accepts on listener i, and with a single listener, the first loop accepts for all. The server owns
+         * the descriptors
+         */
+        tcp_server(const std::vector<int> listeners, const std::function<void(connection*)> handler, const struct options options);
+
         // Member Functions
 
         void                     close();
@@ -105,36 +437,267 @@ namespace mysocket {
         void                     close(class connection* connection);
 
         std::vector<connection*> connections();
+
+        /**
+         * Call function for each open connection, without copying the registry; connections may be added or removed
+         * meanwhile
+         */
+        void                     connections(const std::function<void(connection*)> function) const;
+
+        /**
+         * Stop accepting, leaving the listeners open, and close each connection once its queued segments are sent and
+         * held tasks have run; wait up to timeout for them to close, and return the number still open. Event-loop
+         * mode only
+         */
+        size_t                   drain(const std::chrono::milliseconds timeout);
+
+        /**
+         * Return the listening descriptors, one per loop that accepts; they remain the server's
+         */
+        std::vector<int>         listeners() const;
     private:
+        // Typedef
+
+        /**
+         * Slab of connections addressed by (generation, slot) handles; insert, find, and remove are lock-free and
+         * O(1), and a slot's generation advances on removal so stale handles find nothing
+         */
+        class registry {
+        public:
+            // Constructors
+
+            registry();
+
+            registry(const registry& other) = delete;
+
+            ~registry();
+
+            // Member Functions
+
+            /**
+             * Return the connection named by handle, or NULL if it's been removed
+             */
+            connection* find(const uint64_t handle) const;
+
+            void        for_each(const std::function<void(connection*)> function) const;
+
+            /**
+             * Add connection and return its handle
+             */
+            uint64_t    insert(connection* connection);
+
+            /**
+             * Remove and return the connection named by handle, or return NULL if another caller already did
+             */
+            connection* remove(const uint64_t handle);
+        private:
+            // Typedef
+
+            struct slot {
+                // Member Fields
+
+                std::atomic<class connection*> connection = NULL;
+                std::atomic<uint32_t>          generation = 0;
+
+                // Next free slot + 1, while free
+                std::atomic<uint32_t>          next = 0;
+            };
+
+            // Member Fields
+
+            static constexpr size_t            _chunk_size = 1024;
+
+            // Allocated as slots are first used, and never moved
+            std::atomic<slot*>                 _chunks[4096];
+
+            // Free list head; a tag that counts pushes in the high half, against ABA, and slot + 1 in the low half
+            std::atomic<uint64_t>              _free = 0;
+
+            // Slots ever used
+            std::atomic<uint32_t>              _size = 0;
+
+            // Member Functions
+
+            slot* _slot(const uint32_t index) const;
+        };
+
+        struct event_loop {
+            // Member Fields
+
+            // Served on this loop; touched only on its thread
+            std::unordered_set<connection*> connections;
+
+            // Stopped accepting; connections served from now on are released
+            bool                            draining = false;
+
+            // Shared by every loop unless reuse_port
+            int                             listener = -1;
+            class reactor                   reactor;
+#ifdef __linux__
+            std::unique_ptr<class uring>    ring;
+#endif
+            std::thread                     thread;
+
+            // Reactor watch of listener, if this loop accepts on it
+            uint64_t                        watch = 0;
+        };
+
         // Constructors
 
         ~tcp_server();
 
         // Member Fields
 
-        struct sockaddr_in               _address;
-        int                              _address_length;
-        std::vector<connection*>         _connections;
-        int                              _file_descriptor;
-        std::function<void(connection*)> _handler = [](const class connection* connection){ };
-        std::thread                      _listener;
-        std::mutex                       _mutex;
-        std::atomic<bool>                _shut_down = false;
+        struct sockaddr_in                       _address;
+        int                                      _address_length;
+        registry                                 _connections;
+        int                                      _file_descriptor;
+        std::function<void(connection*)>         _handler = [](const class connection*) { };
+        std::thread                              _listener;
+        std::vector<std::unique_ptr<event_loop>> _loops;
 
-        // Member Functions
+        // Loop assigned the next accepted connection
+        size_t                                   _next_loop = 0;
+        struct options                           _options;
+
+        // Unix-domain path listened on, if any
+        std::string                              _path;
+        std::atomic<bool>                        _shut_down = false;
 
-        int _find_connection(const class connection* connection);
+        // Member Functions
 
-        int _find_connection(const class connection* connection, const size_t start, const size_t end);
+        /**
+         * Accept pending connections on loop's listener
+         */
+        void _accept(const size_t loop);
+
+#ifdef __linux__
+
+        /**
+         * Accept connections onto loop through its ring
+         */
+        void _listen(const size_t loop);
+
+        /**
+         * Receive into connection's buffer through its ring
+         */
+        void _receive(class connection* connection);
+#endif
+
+        /**
+         * Bind listeners to address, one per loop if reuse_port, and start the loops
+         */
+        void _open(const struct sockaddr* address, const socklen_t length);
+
+        /**
+         * Let the overflow option queue a reply to connection, whose buffer is full, then close it once that's sent
+         */
+        void _overflow(class connection* connection);
+
+        /**
+         * Stop watching connection and close it, on its loop; if drain, once its queued segments are sent and its held
+         * tasks have run
+         */
+        void _release(class connection* connection, const bool drain);
+
+        /**
+         * Resume the coroutine awaiting connection's read(), if any, otherwise call the handler
+         */
+        void _received(class connection* connection);
+
+        void _serve(class connection* connection);
+
+        /**
+         * Give loop i listener i, or the first if there are fewer, and start the loops
+         */
+        void _start(const std::vector<int>& listeners);
     };
 
     struct udp_socket {
+        // Typedef
+
+        struct datagram {
+            // Member Fields
+
+            // Source when received; destination when sent, or the socket's peer if unset
+            struct sockaddr_in address = { };
+            std::string_view   data;
+
+            // If nonzero, data holds several datagrams of this size, the last possibly shorter: coalesced on receive
+            // with offload, or split by the kernel on send (UDP_SEGMENT; split here elsewhere)
+            uint16_t           segment_size = 0;
+        };
+
+        /**
+         * Preallocated buffers and headers for a batch of received datagrams, reused across receives
+         */
+        class arena {
+            // Member Fields
+
+            std::vector<char>           _buffers;
+            std::vector<char>           _controls;
+            std::vector<datagram>       _datagrams;
+            std::vector<struct iovec>   _iov;
+            std::vector<struct mmsghdr> _messages;
+            std::vector<struct sockaddr_in> _names;
+            size_t                      _size = 0;
+            size_t                      _message_size;
+        public:
+            // Typedef
+
+            friend udp_socket;
+
+            // Constructors
+
+            /**
+             * Hold up to capacity datagrams of up to message_size bytes each; with offload, message_size should be
+             * 65535
+             */
+            arena(const size_t capacity = 64, const size_t message_size = 2048);
+
+            arena(const arena& other) = delete;
+
+            // Member Functions
+
+            const datagram* begin() const;
+
+            size_t          capacity() const;
+
+            const datagram* end() const;
+
+            /**
+             * Return the number of datagrams held since the last receive
+             */
+            size_t          size() const;
+
+            const datagram& operator[](const size_t index) const;
+        };
+
         // Member Functions
 
         void        close();
 
+        /**
+         * Let the kernel coalesce received datagrams of a flow (UDP_GRO); each then reports its segment_size. Linux
+         * only, elsewhere a no-op
+         */
+        void        offload(const bool value) const;
+
+        /**
+         * Receive up to arena's capacity datagrams, with one system call where supported, and return their number;
+         * if wait, block until the first arrives, otherwise return 0 if none has. Each is valid until arena's next
+         * receive
+         */
+        size_t      recvmmsg(arena& arena, const bool wait = true) const;
+
         std::string recvfrom() const;
 
+        /**
+         * Send datagrams, up to 64 per system call where supported, and return the number sent; fewer only if a later
+         * one failed
+         */
+        size_t      sendmmsg(const std::span<const datagram> datagrams) const;
+
         int         sendto(const std::string message) const;
     protected:
         // Member Fields
@@ -162,6 +725,19 @@ namespace mysocket {
 
         udp_server(const int port);
     };
+
+    // Non-Member Functions
+
+    /**
+     * Fill address for a Unix-domain path, a leading '@' naming one in Linux's abstract namespace, and return its
+     * length
+     */
+    socklen_t local_address(const std::string path, struct sockaddr_un& address);
+
+    /**
+     * Remove the socket file at address if nothing listens on it, as when left by a process that exited
+     */
+    void      unlink_stale(const struct sockaddr_un& address, const socklen_t length);
 }
 
 #endif /* socket_h */
@@ -0,0 +1,48 @@
+//
+//  task.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "task.h"
+#include "socket.h"
+
+namespace mysocket {
+    // Constructors
+
+    sleeper::sleeper(class reactor& reactor, const std::chrono::milliseconds duration) {
+        this->_duration = duration;
+        this->_reactor = &reactor;
+    }
+
+    sleeper::~sleeper() {
+        // Destroyed with its coroutine, before waking
+        this->_reactor->timers().cancel(this->_timer);
+    }
+
+    // Member Functions
+
+    bool sleeper::await_ready() const {
+        return this->_duration.count() <= 0;
+    }
+
+    void sleeper::await_suspend(const std::coroutine_handle<> handle) {
+        this->_timer.function = [handle]() {
+            handle.resume();
+        };
+
+        this->_reactor->timers().arm(this->_timer, this->_duration);
+    }
+
+    // Non-Member Functions
+
+    sleeper sleep_for(const std::chrono::milliseconds duration) {
+        class reactor* reactor = reactor::current();
+
+        if (!reactor)
+            throw mysocket::error(EPERM);
+
+        return sleeper(* reactor, duration);
+    }
+}
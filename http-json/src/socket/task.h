@@ -0,0 +1,222 @@
+//
+//  task.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef task_h
+#define task_h
+
+#include "reactor.h"
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace mysocket {
+    template<typename T = void>
+    class task;
+
+    /**
+     * Shared by every task's promise: what to resume on completion, and the exception thrown, if any
+     */
+    struct _promise_base {
+        // Typedef
+
+        struct final_awaiter {
+            // Member Functions
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            template<typename promise>
+            std::coroutine_handle<> await_suspend(const std::coroutine_handle<promise> handle) const noexcept {
+                _promise_base& base = handle.promise();
+
+                if (base.continuation)
+                    return base.continuation;
+
+                // Detached; nothing owns the frame
+                if (base.detached)
+                    handle.destroy();
+
+                return std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept { }
+        };
+
+        // Member Fields
+
+        std::coroutine_handle<> continuation;
+        bool                    detached = false;
+        std::exception_ptr      exception;
+
+        // Member Functions
+
+        std::suspend_always initial_suspend() const noexcept {
+            return { };
+        }
+
+        final_awaiter       final_suspend() const noexcept {
+            return { };
+        }
+
+        void                unhandled_exception() {
+            this->exception = std::current_exception();
+        }
+    };
+
+    template<typename T>
+    struct _promise: _promise_base {
+        // Member Fields
+
+        std::optional<T> value;
+
+        // Member Functions
+
+        task<T> get_return_object();
+
+        void    return_value(T value) {
+            this->value.emplace(std::move(value));
+        }
+    };
+
+    template<>
+    struct _promise<void>: _promise_base {
+        // Member Functions
+
+        task<void> get_return_object();
+
+        void       return_void() { }
+    };
+
+    /**
+     * Coroutine returning T, started when first awaited; the awaiting coroutine resumes on the thread that completes
+     * it, e.g. the event loop whose I/O or timer it waited on. Exceptions propagate to the awaiter
+     */
+    template<typename T>
+    class task {
+    public:
+        // Typedef
+
+        using promise_type = _promise<T>;
+
+        // Constructors
+
+        task(const std::coroutine_handle<promise_type> handle) {
+            this->_handle = handle;
+        }
+
+        task(const task& other) = delete;
+
+        task(task&& other) noexcept {
+            this->_handle = std::exchange(other._handle, nullptr);
+        }
+
+        ~task() {
+            if (this->_handle)
+                this->_handle.destroy();
+        }
+
+        // Operators
+
+        auto operator co_await() && noexcept {
+            struct awaiter {
+                // Member Fields
+
+                std::coroutine_handle<promise_type> handle;
+
+                // Member Functions
+
+                bool                    await_ready() const noexcept {
+                    return !this->handle || this->handle.done();
+                }
+
+                std::coroutine_handle<> await_suspend(const std::coroutine_handle<> continuation) const noexcept {
+                    this->handle.promise().continuation = continuation;
+
+                    return this->handle;
+                }
+
+                T                       await_resume() const {
+                    promise_type& promise = this->handle.promise();
+
+                    if (promise.exception)
+                        std::rethrow_exception(promise.exception);
+
+                    if constexpr (!std::is_void_v<T>)
+                        return std::move(* promise.value);
+                }
+            };
+
+            return awaiter { this->_handle };
+        }
+
+        // Member Functions
+
+        /**
+         * Run to the first suspension on the calling thread, and free the frame on completion; nothing awaits it,
+         * so an exception it throws is dropped
+         */
+        void detach() && {
+            std::coroutine_handle<promise_type> handle = std::exchange(this->_handle, nullptr);
+
+            handle.promise().detached = true;
+            handle.resume();
+        }
+    private:
+        // Member Fields
+
+        std::coroutine_handle<promise_type> _handle;
+    };
+
+    template<typename T>
+    task<T> _promise<T>::get_return_object() {
+        return task<T>(std::coroutine_handle<_promise<T>>::from_promise(* this));
+    }
+
+    inline task<void> _promise<void>::get_return_object() {
+        return task<void>(std::coroutine_handle<_promise<void>>::from_promise(* this));
+    }
+
+    /**
+     * Awaitable that resumes after duration, on reactor's thread; awaited there
+     */
+    class sleeper {
+    public:
+        // Constructors
+
+        sleeper(class reactor& reactor, const std::chrono::milliseconds duration);
+
+        sleeper(const sleeper& other) = delete;
+
+        ~sleeper();
+
+        // Member Functions
+
+        bool await_ready() const;
+
+        void await_suspend(const std::coroutine_handle<> handle);
+
+        void await_resume() const { }
+    private:
+        // Member Fields
+
+        std::chrono::milliseconds _duration;
+        class reactor*            _reactor;
+        timer_wheel::timer        _timer;
+    };
+
+    // Non-Member Functions
+
+    /**
+     * Resume the awaiting coroutine after duration, on the event loop running on this thread; throw mysocket::error
+     * (EPERM) off an event loop
+     */
+    sleeper sleep_for(const std::chrono::milliseconds duration);
+}
+
+#endif /* task_h */
@@ -0,0 +1,231 @@
+//
+//  timer_wheel.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "timer_wheel.h"
+#include <bit>
+
+namespace mysocket {
+    // Non-Member Fields
+
+    // Level of timers taken from the wheel, to be cascaded or called
+    constexpr int _taken = 1 << 16;
+
+    // Constructors
+
+    timer_wheel::timer_wheel() {
+        this->_start = std::chrono::steady_clock::now();
+    }
+
+    // Member Functions
+
+    void timer_wheel::arm(timer& timer, const std::chrono::milliseconds delay) {
+        this->cancel(timer);
+
+        uint64_t now = std::max(this->_ticks(), this->_now);
+
+        if (delay.count() <= 0)
+            timer._expires = now;
+        else
+            timer._expires = (uint64_t) delay.count() > UINT64_MAX - now ? UINT64_MAX : now + delay.count();
+
+        this->_insert(timer);
+        this->_size++;
+    }
+
+    bool timer_wheel::timer::armed() const {
+        return this->_level != -1;
+    }
+
+    void timer_wheel::cancel(timer& timer) {
+        if (!timer.armed())
+            return;
+
+        this->_unlink(timer);
+
+        timer._level = -1;
+
+        this->_size--;
+    }
+
+    void timer_wheel::_insert(timer& timer) {
+        uint64_t delta = timer._expires - this->_now;
+        int      level = 0;
+
+        while (level < _levels - 1 && delta >> (_bits * (level + 1)))
+            level++;
+
+        // Beyond the last level; wait in its farthest slot, and cascade again from there
+        uint64_t tick = delta >> (_bits * _levels) ? this->_now + (((uint64_t) 1 << (_bits * _levels)) - 1) : timer._expires;
+        int      slot = (int) ((tick >> (_bits * level)) & (_slots - 1));
+        link&    head = this->_wheel[level][slot];
+
+        timer.next = &head;
+        timer.prev = head.prev;
+
+        head.prev->next = &timer;
+        head.prev = &timer;
+
+        timer._level = level;
+        timer._slot = slot;
+
+        this->_occupied[level][slot / 64] |= (uint64_t) 1 << (slot % 64);
+    }
+
+    std::chrono::milliseconds timer_wheel::next() const {
+        uint64_t tick = this->_next_tick();
+
+        if (tick == UINT64_MAX)
+            return std::chrono::milliseconds::max();
+
+        uint64_t now = this->_ticks();
+
+        return std::chrono::milliseconds(tick <= now ? 0 : tick - now);
+    }
+
+    uint64_t timer_wheel::_next_tick() const {
+        if (!this->_size)
+            return UINT64_MAX;
+
+        uint64_t result = UINT64_MAX;
+
+        for (int level = 0; level < _levels; level++) {
+            int shift = _bits * level;
+
+            // Slots of this level run, or cascade, on multiples of its span
+            uint64_t first = (this->_now + ((uint64_t) 1 << shift) - 1) >> shift;
+            int      start = (int) (first & (_slots - 1));
+
+            // Search the slots from start, wrapping around to the bits before it in its word
+            for (int i = 0; i <= _slots / 64; i++) {
+                int      word = (start / 64 + i) % (_slots / 64);
+                uint64_t bits = this->_occupied[level][word];
+
+                if (!i)
+                    bits &= ~(uint64_t) 0 << (start % 64);
+                else if (i == _slots / 64)
+                    bits &= ~(~(uint64_t) 0 << (start % 64));
+
+                if (!bits)
+                    continue;
+
+                int slot = word * 64 + std::countr_zero(bits);
+
+                result = std::min(result, (first + ((slot - start) & (_slots - 1))) << shift);
+
+                break;
+            }
+        }
+
+        return result;
+    }
+
+    void timer_wheel::run() {
+        uint64_t now = this->_ticks();
+
+        while (true) {
+            uint64_t tick = this->_next_tick();
+
+            if (tick > now) {
+                // Nothing is due before now
+                this->_now = std::max(this->_now, now + 1);
+
+                return;
+            }
+
+            this->_now = tick;
+
+            link taken;
+
+            // Cascade from the highest level down, so that timers may fall through several
+            for (int level = _levels - 1; level > 0; level--) {
+                if (tick & (((uint64_t) 1 << (_bits * level)) - 1))
+                    continue;
+
+                int   slot = (int) ((tick >> (_bits * level)) & (_slots - 1));
+                link& head = this->_wheel[level][slot];
+
+                if (head.next == &head)
+                    continue;
+
+                // Take the slot first; timers may return to it
+                taken.next = head.next;
+                taken.prev = head.prev;
+                taken.next->prev = &taken;
+                taken.prev->next = &taken;
+                head.next = head.prev = &head;
+
+                this->_occupied[level][slot / 64] &= ~((uint64_t) 1 << (slot % 64));
+
+                for (link* node = taken.next; node != &taken; node = taken.next) {
+                    timer& timer = static_cast<class timer&>(* node);
+
+                    timer._level = _taken;
+
+                    this->_unlink(timer);
+                    this->_insert(timer);
+                }
+            }
+
+            int   slot = (int) (tick & (_slots - 1));
+            link& head = this->_wheel[0][slot];
+
+            if (head.next != &head) {
+                taken.next = head.next;
+                taken.prev = head.prev;
+                taken.next->prev = &taken;
+                taken.prev->next = &taken;
+                head.next = head.prev = &head;
+
+                this->_occupied[0][slot / 64] &= ~((uint64_t) 1 << (slot % 64));
+
+                for (link* node = taken.next; node != &taken; node = node->next)
+                    static_cast<timer&>(* node)._level = _taken;
+            }
+
+            // Timers armed from here on are due no sooner than the next tick
+            this->_now = tick + 1;
+
+            // Functions may cancel timers still taken, or destroy their own
+            while (taken.next != &taken) {
+                timer& timer = static_cast<class timer&>(* taken.next);
+
+                this->_unlink(timer);
+
+                timer._level = -1;
+
+                this->_size--;
+
+                std::function<void()> function = timer.function;
+
+                if (function)
+                    function();
+            }
+        }
+    }
+
+    size_t timer_wheel::size() const {
+        return this->_size;
+    }
+
+    uint64_t timer_wheel::_ticks() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - this->_start).count();
+    }
+
+    void timer_wheel::_unlink(timer& timer) {
+        timer.prev->next = timer.next;
+        timer.next->prev = timer.prev;
+        timer.next = timer.prev = &timer;
+
+        if (timer._level == _taken)
+            return;
+
+        link& head = this->_wheel[timer._level][timer._slot];
+
+        if (head.next == &head)
+            this->_occupied[timer._level][timer._slot / 64] &= ~((uint64_t) 1 << (timer._slot % 64));
+    }
+}
@@ -0,0 +1,124 @@
+//
+//  timer_wheel.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef timer_wheel_h
+#define timer_wheel_h
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace mysocket {
+    /**
+     * Hierarchical timing wheel with millisecond ticks: four levels of 256 slots, each slot spanning 256 times the
+     * level below's, cover about 49 days; later timers wait in the last level. Arm, cancel, and re-arm are O(1).
+     * Not thread-safe; each event loop owns one
+     */
+    class timer_wheel {
+        // Typedef
+
+        struct link {
+            // Member Fields
+
+            link* next = this;
+            link* prev = this;
+        };
+    public:
+        // Typedef
+
+        /**
+         * Intrusive timer; its owner keeps it alive while armed
+         */
+        class timer: link {
+            // Member Fields
+
+            uint64_t _expires = 0;
+
+            // Position in the wheel; level is -1 while unarmed
+            int      _level = -1;
+            int      _slot = 0;
+        public:
+            // Typedef
+
+            friend timer_wheel;
+
+            // Member Fields
+
+            // Called on expiry, once per arming
+            std::function<void()> function;
+
+            // Constructors
+
+            timer() = default;
+
+            timer(const timer& other) = delete;
+
+            // Member Functions
+
+            bool armed() const;
+        };
+
+        // Constructors
+
+        timer_wheel();
+
+        timer_wheel(const timer_wheel& other) = delete;
+
+        // Member Functions
+
+        /**
+         * Call timer's function once delay passes, replacing any earlier arming
+         */
+        void                      arm(timer& timer, const std::chrono::milliseconds delay);
+
+        void                      cancel(timer& timer);
+
+        /**
+         * Return how long until the next timer may be due, or milliseconds::max() if none is armed
+         */
+        std::chrono::milliseconds next() const;
+
+        /**
+         * Call the functions of timers now due; they may arm and cancel timers, including their own
+         */
+        void                      run();
+
+        size_t                    size() const;
+    private:
+        // Member Fields
+
+        static constexpr int                  _levels = 4;
+
+        // Tick of each level's slots, per bit
+        static constexpr int                  _bits = 8;
+        static constexpr int                  _slots = 1 << _bits;
+
+        // Next tick to run; earlier ones have run
+        uint64_t                              _now = 0;
+
+        // Nonempty slots, per level
+        uint64_t                              _occupied[_levels][_slots / 64] = { };
+        size_t                                _size = 0;
+        link                                  _wheel[_levels][_slots];
+        std::chrono::steady_clock::time_point _start;
+
+        // Member Functions
+
+        void     _insert(timer& timer);
+
+        /**
+         * Return the next tick at or after _now at which a slot must be run or cascaded, or UINT64_MAX if none
+         */
+        uint64_t _next_tick() const;
+
+        uint64_t _ticks() const;
+
+        void     _unlink(timer& timer);
+    };
+}
+
+#endif /* timer_wheel_h */
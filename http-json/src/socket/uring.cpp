@@ -0,0 +1,408 @@
+//
+//  uring.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "uring.h"
+
+#ifdef __linux__
+
+#include "socket.h"
+
+namespace mysocket {
+    // Non-Member Fields
+
+    // Reserved operation ids
+    constexpr uint64_t _reactor_id = 0;
+    constexpr uint64_t _ignored_id = UINT64_MAX;
+
+    // Non-Member Functions
+
+    int _io_uring_enter(const int file_descriptor, const unsigned to_submit, const unsigned min_complete, const unsigned flags, const void* arg, const size_t size) {
+        return (int) syscall(__NR_io_uring_enter, file_descriptor, to_submit, min_complete, flags, arg, size);
+    }
+
+    int _io_uring_register(const int file_descriptor, const unsigned opcode, const void* arg, const unsigned nargs) {
+        return (int) syscall(__NR_io_uring_register, file_descriptor, opcode, arg, nargs);
+    }
+
+    int _io_uring_setup(const unsigned entries, struct io_uring_params* params) {
+        return (int) syscall(__NR_io_uring_setup, entries, params);
+    }
+
+    // Constructors
+
+    uring::uring(class reactor& reactor, const unsigned entries, const unsigned buffers, const size_t buffer_size): _reactor(reactor) {
+        struct io_uring_params params;
+
+        memset(&params, 0, sizeof(params));
+
+        // Defer task work to our own calls into the kernel, if supported
+        params.flags = IORING_SETUP_COOP_TASKRUN;
+
+        this->_file_descriptor = _io_uring_setup(entries, &params);
+
+        if (this->_file_descriptor == -1 && errno == EINVAL) {
+            memset(&params, 0, sizeof(params));
+
+            this->_file_descriptor = _io_uring_setup(entries, &params);
+        }
+
+        if (this->_file_descriptor == -1)
+            throw mysocket::error(errno);
+
+        this->_sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        this->_cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+        // Both rings share one mapping where supported
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            this->_sq_size = this->_cq_size = std::max(this->_sq_size, this->_cq_size);
+
+        this->_sq_ring = mmap(NULL, this->_sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->_file_descriptor, IORING_OFF_SQ_RING);
+        this->_cq_ring = params.features & IORING_FEAT_SINGLE_MMAP ? this->_sq_ring : mmap(NULL, this->_cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->_file_descriptor, IORING_OFF_CQ_RING);
+        this->_sqes = (struct io_uring_sqe*) mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->_file_descriptor, IORING_OFF_SQES);
+
+        if (this->_sq_ring == MAP_FAILED || this->_cq_ring == MAP_FAILED || this->_sqes == MAP_FAILED) {
+            int errnum = errno;
+
+            ::close(this->_file_descriptor);
+
+            throw mysocket::error(errnum);
+        }
+
+        this->_sq_entries = params.sq_entries;
+        this->_sq_head = (unsigned*) ((char*) this->_sq_ring + params.sq_off.head);
+        this->_sq_tail = (unsigned*) ((char*) this->_sq_ring + params.sq_off.tail);
+        this->_sq_mask = * (unsigned*) ((char*) this->_sq_ring + params.sq_off.ring_mask);
+        this->_sq_array = (unsigned*) ((char*) this->_sq_ring + params.sq_off.array);
+        this->_cq_head = (unsigned*) ((char*) this->_cq_ring + params.cq_off.head);
+        this->_cq_tail = (unsigned*) ((char*) this->_cq_ring + params.cq_off.tail);
+        this->_cq_mask = * (unsigned*) ((char*) this->_cq_ring + params.cq_off.ring_mask);
+        this->_cqes = (struct io_uring_cqe*) ((char*) this->_cq_ring + params.cq_off.cqes);
+
+        // Provided buffers; recv picks one per completion. The ring's size must be a power of 2
+        this->_nbuffers = 1;
+
+        while (this->_nbuffers < buffers && this->_nbuffers < 32768)
+            this->_nbuffers <<= 1;
+
+        this->_buffer_size = buffer_size;
+        this->_buffers.resize(this->_nbuffers * buffer_size);
+        this->_buffer_ring = (struct io_uring_buf_ring*) mmap(NULL, this->_nbuffers * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+
+        struct io_uring_buf_reg reg;
+
+        memset(&reg, 0, sizeof(reg));
+
+        reg.ring_addr = (uint64_t) this->_buffer_ring;
+        reg.ring_entries = this->_nbuffers;
+        reg.bgid = 0;
+
+        if (this->_buffer_ring == MAP_FAILED || _io_uring_register(this->_file_descriptor, IORING_REGISTER_PBUF_RING, &reg, 1)) {
+            int errnum = errno;
+
+            if (this->_buffer_ring != MAP_FAILED)
+                munmap(this->_buffer_ring, this->_nbuffers * sizeof(struct io_uring_buf));
+
+            munmap(this->_sqes, params.sq_entries * sizeof(struct io_uring_sqe));
+
+            if (this->_cq_ring != this->_sq_ring)
+                munmap(this->_cq_ring, this->_cq_size);
+
+            munmap(this->_sq_ring, this->_sq_size);
+
+            ::close(this->_file_descriptor);
+
+            throw mysocket::error(errnum);
+        }
+
+        for (unsigned i = 0; i < this->_nbuffers; i++) {
+            struct io_uring_buf* buf = this->_buffer_entry(i);
+
+            buf->addr = (uint64_t) &this->_buffers[i * buffer_size];
+            buf->len = (unsigned) buffer_size;
+            buf->bid = (uint16_t) i;
+        }
+
+        __atomic_store_n(&this->_buffer_ring->tail, (uint16_t) this->_nbuffers, __ATOMIC_RELEASE);
+    }
+
+    uring::~uring() {
+        munmap(this->_buffer_ring, this->_nbuffers * sizeof(struct io_uring_buf));
+        munmap(this->_sqes, this->_sq_entries * sizeof(struct io_uring_sqe));
+
+        if (this->_cq_ring != this->_sq_ring)
+            munmap(this->_cq_ring, this->_cq_size);
+
+        munmap(this->_sq_ring, this->_sq_size);
+
+        ::close(this->_file_descriptor);
+
+        // Their operations went with the ring
+        for (auto& [file_descriptor, done]: this->_canceling)
+            done();
+    }
+
+    // Member Functions
+
+    uint64_t uring::accept(const int file_descriptor, const completion completion) {
+        uint64_t             id = this->_add(file_descriptor, completion);
+        struct io_uring_sqe* sqe = this->_sqe(IORING_OP_ACCEPT, file_descriptor, id);
+
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+
+        return id;
+    }
+
+    uint64_t uring::_add(const int file_descriptor, const completion completion) {
+        uint64_t id = this->_next++;
+
+        this->_operations[id] = { completion, file_descriptor };
+        this->_descriptors.insert({ file_descriptor, id });
+
+        return id;
+    }
+
+    std::string_view uring::buffer(const int result, const uint32_t flags) const {
+        return std::string_view(&this->_buffers[(flags >> IORING_CQE_BUFFER_SHIFT) * this->_buffer_size], result);
+    }
+
+    struct io_uring_buf* uring::_buffer_entry(const unsigned index) const {
+        // Not bufs[index]; in C++, the header's flexible array member is offset past an empty struct
+        return (struct io_uring_buf*) this->_buffer_ring + index;
+    }
+
+    void uring::cancel(const int file_descriptor, const std::function<void()> done) {
+        auto range = this->_descriptors.equal_range(file_descriptor);
+
+        for (auto it = range.first; it != range.second; it++)
+            this->_operations[it->second].canceled = true;
+
+        if (done) {
+            // Never from within the caller
+            if (range.first == range.second)
+                this->_reactor.post(done);
+            else
+                this->_canceling[file_descriptor] = done;
+        }
+
+        struct io_uring_sqe* sqe = this->_sqe(IORING_OP_ASYNC_CANCEL, file_descriptor, _ignored_id);
+
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+
+        // Before the descriptor is closed, and its number reused
+        this->_enter(0, std::chrono::milliseconds(0));
+    }
+
+    void uring::_enter(const unsigned min_complete, const std::chrono::milliseconds timeout) {
+        struct __kernel_timespec     ts = { timeout.count() / 1000, (timeout.count() % 1000) * 1000000 };
+        struct io_uring_getevents_arg arg;
+
+        memset(&arg, 0, sizeof(arg));
+
+        if (timeout != std::chrono::milliseconds::max())
+            arg.ts = (uint64_t) &ts;
+
+        int result = _io_uring_enter(this->_file_descriptor, this->_pending, min_complete, (min_complete ? IORING_ENTER_GETEVENTS : 0) | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+
+        if (result >= 0)
+            this->_pending -= std::min((unsigned) result, this->_pending);
+        else if (errno != EINTR && errno != ETIME && errno != EBUSY && errno != EAGAIN)
+            throw mysocket::error(errno);
+    }
+
+    uint64_t uring::poll(const int file_descriptor, const short events, const completion completion) {
+        uint64_t             id = this->_add(file_descriptor, completion);
+        struct io_uring_sqe* sqe = this->_sqe(IORING_OP_POLL_ADD, file_descriptor, id);
+
+        sqe->poll32_events = events;
+
+        return id;
+    }
+
+    uint64_t uring::recv(const int file_descriptor, const completion completion) {
+        uint64_t             id = this->_add(file_descriptor, completion);
+        struct io_uring_sqe* sqe = this->_sqe(IORING_OP_RECV, file_descriptor, id);
+
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = 0;
+
+        return id;
+    }
+
+    void uring::recycle(const uint32_t flags) {
+        uint16_t             bid = flags >> IORING_CQE_BUFFER_SHIFT;
+        uint16_t             tail = this->_buffer_ring->tail;
+        struct io_uring_buf* buf = this->_buffer_entry(tail & (this->_nbuffers - 1));
+
+        buf->addr = (uint64_t) &this->_buffers[bid * this->_buffer_size];
+        buf->len = (unsigned) this->_buffer_size;
+        buf->bid = bid;
+
+        __atomic_store_n(&this->_buffer_ring->tail, (uint16_t) (tail + 1), __ATOMIC_RELEASE);
+    }
+
+    void uring::run() {
+        // Nest the reactor; its descriptor is readable while it has events or tasks
+        auto arm = [this]() {
+            struct io_uring_sqe* sqe = this->_sqe(IORING_OP_POLL_ADD, this->_reactor.file_descriptor(), _reactor_id);
+
+            sqe->len = IORING_POLL_ADD_MULTI;
+            sqe->poll32_events = POLLIN;
+        };
+
+        arm();
+
+        this->_running.store(true);
+
+        // Tasks posted before the loop started
+        this->_reactor.poll();
+
+        while (this->_running.load()) {
+            // Wait no longer than the reactor's next timer
+            this->_enter(1, this->_reactor.timers().next());
+
+            unsigned head = * this->_cq_head;
+
+            while (head != __atomic_load_n(this->_cq_tail, __ATOMIC_ACQUIRE)) {
+                struct io_uring_cqe cqe = this->_cqes[head & this->_cq_mask];
+
+                __atomic_store_n(this->_cq_head, ++head, __ATOMIC_RELEASE);
+
+                if (cqe.user_data == _ignored_id)
+                    continue;
+
+                if (cqe.user_data == _reactor_id) {
+                    this->_reactor.poll();
+
+                    if (!(cqe.flags & IORING_CQE_F_MORE))
+                        arm();
+
+                    continue;
+                }
+
+                auto it = this->_operations.find(cqe.user_data);
+
+                if (it == this->_operations.end())
+                    continue;
+
+                // Completions may add operations, so call a copy
+                completion function;
+                bool       canceled = it->second.canceled;
+                int        file_descriptor = it->second.file_descriptor;
+
+                if (cqe.flags & IORING_CQE_F_MORE)
+                    function = it->second.function;
+                else {
+                    function = std::move(it->second.function);
+
+                    auto range = this->_descriptors.equal_range(file_descriptor);
+
+                    for (auto descriptor = range.first; descriptor != range.second; descriptor++)
+                        if (descriptor->second == cqe.user_data) {
+                            this->_descriptors.erase(descriptor);
+
+                            break;
+                        }
+
+                    this->_operations.erase(it);
+                }
+
+                if (!canceled) {
+                    function(cqe.res, cqe.flags);
+
+                    continue;
+                }
+
+                auto done = this->_canceling.find(file_descriptor);
+
+                // The descriptor's last
+                if (done != this->_canceling.end() && !this->_descriptors.contains(file_descriptor)) {
+                    std::function<void()> release = std::move(done->second);
+
+                    this->_canceling.erase(done);
+
+                    release();
+                }
+            }
+
+            this->_reactor.timers().run();
+        }
+    }
+
+    uint64_t uring::sendmsg(const int file_descriptor, const struct msghdr* message, const completion completion) {
+        uint64_t             id = this->_add(file_descriptor, completion);
+        struct io_uring_sqe* sqe = this->_sqe(IORING_OP_SENDMSG, file_descriptor, id);
+
+        sqe->addr = (uint64_t) message;
+        sqe->len = 1;
+        sqe->msg_flags = MSG_NOSIGNAL;
+
+        return id;
+    }
+
+    struct io_uring_sqe* uring::_sqe(const uint8_t opcode, const int file_descriptor, const uint64_t id) {
+        // Full; submit what's queued
+        while (* this->_sq_tail - __atomic_load_n(this->_sq_head, __ATOMIC_ACQUIRE) >= this->_sq_entries)
+            this->_enter(0, std::chrono::milliseconds(0));
+
+        unsigned             tail = * this->_sq_tail;
+        unsigned             index = tail & this->_sq_mask;
+        struct io_uring_sqe* sqe = &this->_sqes[index];
+
+        memset(sqe, 0, sizeof(* sqe));
+
+        sqe->opcode = opcode;
+        sqe->fd = file_descriptor;
+        sqe->user_data = id;
+
+        this->_sq_array[index] = index;
+
+        __atomic_store_n(this->_sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+        this->_pending++;
+
+        return sqe;
+    }
+
+    void uring::stop() {
+        this->_running.store(false);
+        this->_reactor.stop();
+    }
+
+    bool uring::supported() {
+        struct utsname name;
+
+        // Multishot recv
+        if (uname(&name) || std::atoi(name.release) < 6)
+            return false;
+
+        struct io_uring_params params;
+
+        memset(&params, 0, sizeof(params));
+
+        int file_descriptor = _io_uring_setup(4, &params);
+
+        // Disabled, or filtered
+        if (file_descriptor == -1)
+            return false;
+
+        size_t                  size = sizeof(struct io_uring_probe) + IORING_OP_LAST * sizeof(struct io_uring_probe_op);
+        std::vector<char>       probe(size, 0);
+        struct io_uring_probe*  ops = (struct io_uring_probe*) probe.data();
+        bool                    result = _io_uring_register(file_descriptor, IORING_REGISTER_PROBE, ops, IORING_OP_LAST) == 0;
+
+        for (uint8_t opcode: { IORING_OP_ACCEPT, IORING_OP_ASYNC_CANCEL, IORING_OP_POLL_ADD, IORING_OP_RECV, IORING_OP_SENDMSG })
+            result = result && opcode <= ops->last_op && (ops->ops[opcode].flags & IO_URING_OP_SUPPORTED);
+
+        ::close(file_descriptor);
+
+        return result;
+    }
+}
+
+#endif
@@ -0,0 +1,163 @@
+//
+//  uring.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef uring_h
+#define uring_h
+
+#ifdef __linux__
+
+#include "reactor.h"
+#include <linux/io_uring.h>
+#include <map>
+#include <poll.h>
+#include <sys/mman.h>   // mmap
+#include <sys/socket.h> // msghdr
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+
+namespace mysocket {
+    /**
+     * Completion-based socket I/O over io_uring, with its reactor's events and tasks nested in; Linux only.
+     * Operations are submitted and completed on the loop's thread
+     */
+    class uring {
+    public:
+        // Typedef
+
+        /**
+         * Called with an operation's result, a byte count or descriptor, or -errno, and its completion flags; multishot
+         * operations are called until flags lacks IORING_CQE_F_MORE
+         */
+        using completion = std::function<void(const int result, const uint32_t flags)>;
+
+        // Constructors
+
+        uring(class reactor& reactor, const unsigned entries = 1024, const unsigned buffers = 1024, const size_t buffer_size = 16384);
+
+        uring(const uring& other) = delete;
+
+        ~uring();
+
+        // Member Functions
+
+        /**
+         * Accept connections on file_descriptor until canceled; results are non-blocking descriptors
+         */
+        uint64_t         accept(const int file_descriptor, const completion completion);
+
+        /**
+         * Return the provided buffer holding a recv result
+         */
+        std::string_view buffer(const int result, const uint32_t flags) const;
+
+        /**
+         * Cancel every operation on file_descriptor, immediately; their completions aren't called again. done, if
+         * any, runs on the loop once the kernel is finished with them, so that the descriptor and their buffers may
+         * be released
+         */
+        void             cancel(const int file_descriptor, const std::function<void()> done = nullptr);
+
+        /**
+         * Wait once for events on file_descriptor
+         */
+        uint64_t         poll(const int file_descriptor, const short events, const completion completion);
+
+        /**
+         * Receive into provided buffers until canceled or out of buffers; recycle each buffer once consumed
+         */
+        uint64_t         recv(const int file_descriptor, const completion completion);
+
+        /**
+         * Return a recv result's buffer to the kernel
+         */
+        void             recycle(const uint32_t flags);
+
+        /**
+         * Dispatch completions, and the reactor's events, tasks, and timers, on the calling thread until stop()
+         */
+        void             run();
+
+        /**
+         * Send message; it and its buffers must outlive the completion
+         */
+        uint64_t         sendmsg(const int file_descriptor, const struct msghdr* message, const completion completion);
+
+        void             stop();
+
+        /**
+         * Return true if the kernel supports the operations used here
+         */
+        static bool      supported();
+    private:
+        // Typedef
+
+        struct operation {
+            // Member Fields
+
+            completion function;
+            int        file_descriptor;
+
+            // Canceled; kept until its last completion
+            bool       canceled = false;
+        };
+
+        // Member Fields
+
+        struct io_uring_buf_ring*                  _buffer_ring;
+        size_t                                     _buffer_size;
+        std::vector<char>                          _buffers;
+
+        // Called once a canceled descriptor's last operation completes
+        std::map<int, std::function<void()>>       _canceling;
+
+        // Operations by descriptor, to cancel them together
+        std::unordered_multimap<int, uint64_t>     _descriptors;
+        int                                        _file_descriptor;
+        unsigned                                   _nbuffers;
+        uint64_t                                   _next = 1;
+        std::unordered_map<uint64_t, operation>    _operations;
+        class reactor&                             _reactor;
+        std::atomic<bool>                          _running = false;
+
+        // Submission and completion queues, mapped from the kernel
+        unsigned*                                  _cq_head;
+        unsigned                                   _cq_mask;
+        unsigned*                                  _cq_tail;
+        struct io_uring_cqe*                       _cqes;
+        unsigned*                                  _sq_array;
+        unsigned*                                  _sq_head;
+        unsigned                                   _sq_mask;
+        unsigned*                                  _sq_tail;
+        struct io_uring_sqe*                       _sqes;
+        unsigned                                   _sq_entries;
+        size_t                                     _sq_size;
+        size_t                                     _cq_size;
+        void*                                      _sq_ring;
+        void*                                      _cq_ring;
+
+        // Submitted since the last enter
+        unsigned                                   _pending = 0;
+
+        // Member Functions
+
+        uint64_t             _add(const int file_descriptor, const completion completion);
+
+        struct io_uring_buf* _buffer_entry(const unsigned index) const;
+
+        /**
+         * Submit pending entries and wait for at least min_complete completions, or timeout; milliseconds::max() waits
+         * indefinitely
+         */
+        void                 _enter(const unsigned min_complete, const std::chrono::milliseconds timeout);
+
+        struct io_uring_sqe* _sqe(const uint8_t opcode, const int file_descriptor, const uint64_t id);
+    };
+}
+
+#endif
+
+#endif /* uring_h */
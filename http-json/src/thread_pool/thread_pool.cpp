@@ -0,0 +1,153 @@
+//
+//  thread_pool.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "thread_pool.h"
+
+namespace http {
+    // Non-Member Fields
+
+    // Pool and index of the worker running on this thread, if any
+    thread_local const thread_pool* _current_pool = NULL;
+    thread_local size_t             _current_worker = 0;
+
+    // Constructors
+
+    thread_pool::thread_pool(const size_t size, const size_t capacity) {
+        this->_capacity = capacity;
+
+        for (size_t i = 0; i < std::max(size, (size_t) 1); i++)
+            this->_workers.push_back(std::make_unique<worker>());
+
+        // Workers steal from each other, so all exist before any starts
+        for (size_t i = 0; i < this->_workers.size(); i++)
+            this->_workers[i]->thread = std::thread([this, i]() {
+                this->_run(i);
+            });
+    }
+
+    thread_pool::~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+
+            this->_stopping = true;
+        }
+
+        this->_idle.notify_all();
+
+        for (std::unique_ptr<worker>& worker: this->_workers)
+            worker->thread.join();
+    }
+
+    // Member Functions
+
+    bool thread_pool::_pop(const size_t index, task& task) {
+        worker&                     worker = * this->_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+
+        if (worker.tasks.empty())
+            return false;
+
+        task = std::move(worker.tasks.back());
+
+        worker.tasks.pop_back();
+
+        this->_depth--;
+
+        return true;
+    }
+
+    void thread_pool::_run(const size_t index) {
+        _current_pool = this;
+        _current_worker = index;
+
+        while (true) {
+            task task;
+
+            if (this->_pop(index, task) || this->_steal(index, task)) {
+                try {
+                    task();
+                } catch (...) {
+                    // Keep the worker
+                }
+
+                this->_executed++;
+
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(this->_mutex);
+
+            this->_idle.wait(lock, [this]() {
+                return this->_stopping || this->_depth.load();
+            });
+
+            // Queued tasks run first
+            if (this->_stopping && !this->_depth.load())
+                return;
+        }
+    }
+
+    bool thread_pool::_steal(const size_t index, task& task) {
+        for (size_t i = 1; i < this->_workers.size(); i++) {
+            worker&                     victim = * this->_workers[(index + i) % this->_workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+
+            if (victim.tasks.empty())
+                continue;
+
+            task = std::move(victim.tasks.front());
+
+            victim.tasks.pop_front();
+
+            this->_depth--;
+            this->_steals++;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    struct thread_pool::stats thread_pool::stats() const {
+        struct stats result;
+
+        result.depth = this->_depth.load();
+        result.executed = this->_executed.load();
+        result.rejected = this->_rejected.load();
+        result.steals = this->_steals.load();
+        result.workers = this->_workers.size();
+
+        return result;
+    }
+
+    bool thread_pool::submit(const task task) {
+        // Reserve a place first, so that capacity holds under contention
+        if (this->_depth.fetch_add(1) >= this->_capacity && this->_capacity) {
+            this->_depth--;
+            this->_rejected++;
+
+            return false;
+        }
+
+        worker& worker = * this->_workers[_current_pool == this ? _current_worker : this->_next++ % this->_workers.size()];
+
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+
+            worker.tasks.push_back(task);
+        }
+
+        // Idle workers check depth under this mutex, so the wake up isn't lost
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+        }
+
+        this->_idle.notify_one();
+
+        return true;
+    }
+}
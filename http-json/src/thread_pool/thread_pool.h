@@ -0,0 +1,105 @@
+//
+//  thread_pool.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef thread_pool_h
+#define thread_pool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace http {
+    /**
+     * Fixed set of worker threads, each with its own deque of tasks; a worker runs its newest task first and, when it
+     * has none, steals its peers' oldest
+     */
+    class thread_pool {
+    public:
+        // Typedef
+
+        using task = std::function<void()>;
+
+        struct stats {
+            // Member Fields
+
+            // Tasks queued but not yet started
+            size_t depth = 0;
+            size_t executed = 0;
+            size_t rejected = 0;
+            size_t steals = 0;
+            size_t workers = 0;
+        };
+
+        // Constructors
+
+        /**
+         * Start size workers; unless capacity is 0, no more than capacity tasks are queued at once
+         */
+        thread_pool(const size_t size = std::max(std::thread::hardware_concurrency(), 1u), const size_t capacity = 0);
+
+        thread_pool(const thread_pool& other) = delete;
+
+        /**
+         * Run queued tasks, then join the workers
+         */
+        ~thread_pool();
+
+        // Member Functions
+
+        /**
+         * Queue task and return true, or return false if the pool is at capacity; tasks submitted by a worker join
+         * its own deque. Exceptions thrown by task are discarded
+         */
+        bool         submit(const task task);
+
+        struct stats stats() const;
+    private:
+        // Typedef
+
+        struct worker {
+            // Member Fields
+
+            std::mutex       mutex;
+
+            // Owner pops the back; thieves take the front
+            std::deque<task> tasks;
+            std::thread      thread;
+        };
+
+        // Member Fields
+
+        size_t                               _capacity;
+        std::atomic<size_t>                  _depth = 0;
+        std::atomic<size_t>                  _executed = 0;
+
+        // Wakes idle workers
+        std::condition_variable              _idle;
+        std::mutex                           _mutex;
+
+        // Worker given the next task submitted from outside the pool
+        std::atomic<size_t>                  _next = 0;
+        std::atomic<size_t>                  _rejected = 0;
+        std::atomic<size_t>                  _steals = 0;
+        bool                                 _stopping = false;
+        std::vector<std::unique_ptr<worker>> _workers;
+
+        // Member Functions
+
+        bool _pop(const size_t index, task& task);
+
+        void _run(const size_t index);
+
+        bool _steal(const size_t index, task& task);
+    };
+}
+
+#endif /* thread_pool_h */
@@ -461,3 +461,83 @@ std::string trim_end(const std::string string) {
         
     return string.substr(0, end);
 }
+
+std::string_view trim_view(std::string_view string) {
+    while (string.length() && isspace(string.front()))
+        string.remove_prefix(1);
+
+    while (string.length() && isspace(string.back()))
+        string.remove_suffix(1);
+
+    return string;
+}
+
+uint64_t xxhash64(const std::string_view text, const uint64_t seed) {
+    const uint64_t p1 = 11400714785074694791ULL,
+                   p2 = 14029467366897019727ULL,
+                   p3 = 1609587929392839161ULL,
+                   p4 = 9650029242287828579ULL,
+                   p5 = 2870177450012600261ULL;
+
+    auto rotl = [](const uint64_t value, const int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    };
+
+    // Little-endian
+    auto read = [](const char* data, const size_t size) {
+        uint64_t value = 0;
+
+        memcpy(&value, data, size);
+
+        return value;
+    };
+
+    auto round = [&](const uint64_t accumulator, const uint64_t input) {
+        return rotl(accumulator + input * p2, 31) * p1;
+    };
+
+    const char* data = text.data();
+    const char* end = data + text.length();
+    uint64_t    result;
+
+    if (text.length() >= 32) {
+        uint64_t v1 = seed + p1 + p2,
+                 v2 = seed + p2,
+                 v3 = seed,
+                 v4 = seed - p1;
+
+        for (; data + 32 <= end; data += 32) {
+            v1 = round(v1, read(data, 8));
+            v2 = round(v2, read(data + 8, 8));
+            v3 = round(v3, read(data + 16, 8));
+            v4 = round(v4, read(data + 24, 8));
+        }
+
+        result = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+
+        for (uint64_t value: { v1, v2, v3, v4 })
+            result = (result ^ round(0, value)) * p1 + p4;
+    } else
+        result = seed + p5;
+
+    result += text.length();
+
+    for (; data + 8 <= end; data += 8)
+        result = rotl(result ^ round(0, read(data, 8)), 27) * p1 + p4;
+
+    if (data + 4 <= end) {
+        result = rotl(result ^ (read(data, 4) * p1), 23) * p2 + p3;
+        data += 4;
+    }
+
+    for (; data < end; data++)
+        result = rotl(result ^ (static_cast<uint8_t>(* data) * p5), 11) * p1;
+
+    result ^= result >> 33;
+    result *= p2;
+    result ^= result >> 29;
+    result *= p3;
+    result ^= result >> 32;
+
+    return result;
+}
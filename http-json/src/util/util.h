@@ -8,9 +8,12 @@
 #ifndef util_h
 #define util_h
 
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <random>
 #include <sstream>
+#include <string_view>
 
 // Non-Member Functions
 
@@ -63,4 +66,14 @@ std::string              trim(const std::string string);
 
 std::string              trim_end(const std::string string);
 
+/**
+ * Return a view of string without leading or trailing whitespace
+ */
+std::string_view         trim_view(const std::string_view string);
+
+/**
+ * Return the 64-bit xxHash (XXH64) of text
+ */
+uint64_t                 xxhash64(const std::string_view text, const uint64_t seed = 0);
+
 #endif /* util_h */
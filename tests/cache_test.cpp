@@ -0,0 +1,213 @@
+//
+//  cache_test.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "cache.h"
+#include "test.h"
+#include <thread>
+
+using namespace http;
+
+// Handler whose responses are length bytes and name the request's URL; counts its calls
+static router::handler counted(size_t& calls, const size_t length = 64) {
+    return [&calls, length](const request& request, const router::params&) {
+        std::string message = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\nX-URL: " + request.url() + "\r\n\r\n";
+
+        calls++;
+
+        message.resize(length, ' ');
+
+        return std::make_shared<const std::string>(message);
+    };
+}
+
+static request get(const std::string target, const std::string headers = "") {
+    return request("GET " + target + " HTTP/1.1\r\nHost: a\r\n" + headers + "\r\n");
+}
+
+TEST(cache_serves_hits) {
+    cache           cache;
+    cache::policy   policy;
+    size_t          calls = 0;
+
+    policy.ttl = std::chrono::seconds(60);
+
+    router::handler handler = cache.route(policy, counted(calls));
+
+    std::shared_ptr<const std::string> first = handler(get("/a"), { });
+    std::shared_ptr<const std::string> second = handler(get("/a"), { });
+
+    CHECK(calls == 1);
+    CHECK(* first == * second);
+
+    // Trailing slashes are normalized
+    handler(get("/a/"), { });
+
+    CHECK(calls == 1);
+
+    handler(get("/b"), { });
+
+    CHECK(calls == 2);
+    CHECK(cache.stats().hits == 2);
+    CHECK(cache.stats().misses == 2);
+    CHECK(cache.stats().entries == 2);
+
+    cache.clear();
+    handler(get("/a"), { });
+
+    CHECK(calls == 3);
+}
+
+TEST(cache_skips_uncacheable_responses) {
+    cache           cache;
+    size_t          calls = 0;
+    router::handler handler = cache.route({ }, [&calls](const request&, const router::params&) {
+        calls++;
+
+        return std::make_shared<const std::string>("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+    });
+
+    handler(get("/a"), { });
+    handler(get("/a"), { });
+
+    CHECK(calls == 2);
+    CHECK(!cache.stats().entries);
+}
+
+TEST(cache_evicts_least_recently_used_within_byte_budget) {
+    // One shard, so that it has the whole budget
+    cache           cache(1);
+    cache::policy   policy;
+    size_t          calls = 0;
+
+    policy.max_bytes = 3 * 100;
+    policy.ttl = std::chrono::seconds(60);
+
+    router::handler handler = cache.route(policy, counted(calls, 100));
+
+    handler(get("/a"), { });
+    handler(get("/b"), { });
+    handler(get("/c"), { });
+
+    // Most recently used; /b is now least
+    handler(get("/a"), { });
+
+    CHECK(calls == 3);
+
+    handler(get("/d"), { });
+
+    CHECK(cache.stats().entries == 3);
+    CHECK(cache.stats().bytes == 300);
+
+    handler(get("/a"), { });
+    handler(get("/c"), { });
+    handler(get("/d"), { });
+
+    CHECK(calls == 4);
+
+    handler(get("/b"), { });
+
+    CHECK(calls == 5);
+
+    // Larger than the budget; not cached
+    router::handler large = cache.route(policy, counted(calls, 301));
+
+    large(get("/e"), { });
+    large(get("/e"), { });
+
+    CHECK(calls == 7);
+}
+
+TEST(cache_keeps_to_entry_budget_across_shards) {
+    cache           cache;
+    cache::policy   policy;
+    size_t          calls = 0;
+
+    policy.max_entries = 4;
+    policy.ttl = std::chrono::seconds(60);
+
+    router::handler handler = cache.route(policy, counted(calls));
+
+    for (int i = 0; i < 64; i++)
+        handler(get("/" + std::to_string(i)), { });
+
+    CHECK(cache.stats().entries <= 4);
+    CHECK(cache.stats().entries >= 1);
+}
+
+TEST(cache_keys_by_parameters) {
+    cache           cache;
+    cache::policy   policy;
+    size_t          calls = 0;
+
+    policy.ttl = std::chrono::seconds(60);
+
+    router::handler handler = cache.route(policy, counted(calls));
+
+    handler(get("/a?x=1&y=2"), { });
+
+    // Parameters are ordered by name
+    handler(get("/a?y=2&x=1"), { });
+
+    CHECK(calls == 1);
+
+    handler(get("/a?x=1"), { });
+    handler(get("/a?x=2&y=2"), { });
+
+    CHECK(calls == 3);
+
+    // An '&' in a value doesn't separate parameters
+    handler(get("/a?x=1%26y%3D2"), { });
+
+    CHECK(calls == 4);
+}
+
+TEST(cache_keys_by_vary_headers) {
+    cache           cache;
+    cache::policy   policy;
+    size_t          calls = 0;
+
+    policy.ttl = std::chrono::seconds(60);
+    policy.vary = { "Accept-Language" };
+
+    router::handler handler = cache.route(policy, counted(calls));
+
+    handler(get("/a", "Accept-Language: en\r\n"), { });
+    handler(get("/a", "accept-language: en\r\n"), { });
+
+    CHECK(calls == 1);
+
+    handler(get("/a", "Accept-Language: fr\r\n"), { });
+    handler(get("/a"), { });
+
+    CHECK(calls == 3);
+
+    // Other headers don't matter
+    handler(get("/a", "Accept-Language: fr\r\nUser-Agent: b\r\n"), { });
+
+    CHECK(calls == 3);
+}
+
+TEST(cache_expires_lazily) {
+    cache           cache;
+    cache::policy   policy;
+    size_t          calls = 0;
+
+    policy.ttl = std::chrono::milliseconds(20);
+
+    router::handler handler = cache.route(policy, counted(calls));
+
+    handler(get("/a"), { });
+    handler(get("/a"), { });
+
+    CHECK(calls == 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+
+    handler(get("/a"), { });
+
+    CHECK(calls == 2);
+}
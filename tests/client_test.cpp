@@ -0,0 +1,114 @@
+//
+//  client_test.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "client.h"
+#include "test.h"
+
+using namespace http;
+
+TEST(response_length_awaits_the_header_section) {
+    bool keep_alive;
+
+    CHECK(response_length("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n", false, false, keep_alive) == 0);
+}
+
+TEST(response_length_with_content_length) {
+    std::string head = "HTTP/1.1 200 OK\r\nContent-Length: 3\r\n\r\n";
+    bool        keep_alive;
+
+    CHECK(response_length(head + "ab", false, false, keep_alive) == 0);
+    CHECK(response_length(head + "abcHTTP/1.1", false, false, keep_alive) == head.length() + 3);
+    CHECK(keep_alive);
+}
+
+TEST(response_length_with_chunked_body) {
+    std::string head = "HTTP/1.1 200 OK\r\nContent-Length: 1\r\nTransfer-Encoding: chunked\r\n\r\n",
+                body = "3\r\nabc\r\n0\r\n\r\n";
+    bool        keep_alive;
+
+    CHECK(response_length(head + body.substr(0, body.length() - 1), false, false, keep_alive) == 0);
+    CHECK(response_length(head + body, false, false, keep_alive) == head.length() + body.length());
+    CHECK_THROWS(response_length(head + "x\r\n", false, false, keep_alive), mysocket::error);
+}
+
+TEST(response_length_without_a_body) {
+    bool keep_alive;
+
+    // Content-Length describes what a GET would have received
+    std::string head = "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\n";
+
+    CHECK(response_length(head, true, false, keep_alive) == head.length());
+
+    for (const std::string status: { "100 Continue", "204 No Content", "304 Not Modified" }) {
+        std::string message = "HTTP/1.1 " + status + "\r\nContent-Length: 10\r\n\r\n";
+
+        CHECK(response_length(message, false, false, keep_alive) == message.length());
+    }
+}
+
+TEST(response_length_delimited_by_closing) {
+    std::string message = "HTTP/1.1 200 OK\r\n\r\nabc";
+    bool        keep_alive = true;
+
+    CHECK(response_length(message, false, false, keep_alive) == 0);
+    CHECK(!keep_alive);
+    CHECK(response_length(message, false, true, keep_alive) == message.length());
+}
+
+TEST(response_length_reads_connection_options) {
+    bool keep_alive;
+
+    response_length("HTTP/1.1 204 No Content\r\nConnection: Upgrade, Close\r\n\r\n", false, false, keep_alive);
+
+    CHECK(!keep_alive);
+
+    response_length("HTTP/1.0 204 No Content\r\n\r\n", false, false, keep_alive);
+
+    CHECK(!keep_alive);
+
+    response_length("HTTP/1.0 204 No Content\r\nConnection: keep-alive\r\n\r\n", false, false, keep_alive);
+
+    CHECK(keep_alive);
+}
+
+TEST(response_length_rejects_malformed_responses) {
+    bool keep_alive;
+
+    CHECK_THROWS(response_length("HTTP/2 200 OK\r\n\r\n", false, false, keep_alive), mysocket::error);
+    CHECK_THROWS(response_length("HTTP/1.1 2xx OK\r\n\r\n", false, false, keep_alive), mysocket::error);
+    CHECK_THROWS(response_length("HTTP/1.1 200 OK\r\nContent-Length: -1\r\n\r\n", false, false, keep_alive), mysocket::error);
+}
+
+TEST(response_length_rejects_conflicting_content_lengths) {
+    bool keep_alive;
+
+    CHECK_THROWS(response_length("HTTP/1.1 200 OK\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\nab", false, false, keep_alive), mysocket::error);
+}
+
+TEST(response_framer_frames_responses_arriving_in_pieces) {
+    std::string         first = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n0\r\n\r\n",
+                        second = "HTTP/1.1 304 Not Modified\r\nContent-Length: 10\r\n\r\n",
+                        stream = first + second;
+    response_framer     framer;
+    bool                keep_alive;
+    std::vector<size_t> lengths;
+    size_t              start = 0;
+
+    // Read a byte at a time, taking responses as they complete
+    for (size_t end = 1; end <= stream.length(); end++) {
+        size_t length = framer.length(std::string_view(stream).substr(start, end - start), false, false, keep_alive);
+
+        if (length) {
+            lengths.push_back(length);
+
+            start += length;
+        }
+    }
+
+    CHECK(lengths == std::vector<size_t>({ first.length(), second.length() }));
+    CHECK(keep_alive);
+}
@@ -0,0 +1,177 @@
+//
+//  http_test.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "http.h"
+#include "test.h"
+
+using namespace http;
+
+TEST(message_length_awaits_the_header_section) {
+    CHECK(message_length("") == 0);
+    CHECK(message_length("GET / HTTP/1.1\r\nHost: a\r\n") == 0);
+    CHECK(message_length("GET / HTTP/1.1\r\nHost: a\r\n\r") == 0);
+}
+
+TEST(message_length_without_a_body) {
+    std::string message = "GET / HTTP/1.1\r\nHost: a\r\n\r\n";
+
+    CHECK(message_length(message) == message.length());
+
+    // Bare LF terminators
+    std::string bare = "GET / HTTP/1.1\nHost: a\n\n";
+
+    CHECK(message_length(bare) == bare.length());
+}
+
+TEST(message_length_with_content_length) {
+    std::string head = "POST / HTTP/1.1\r\ncontent-length:  5 \r\n\r\n";
+
+    CHECK(message_length(head) == 0);
+    CHECK(message_length(head + "abcd") == 0);
+    CHECK(message_length(head + "abcde") == head.length() + 5);
+
+    // Pipelined; only the first message counts
+    CHECK(message_length(head + "abcdeGET / HTTP/1.1\r\n\r\n") == head.length() + 5);
+}
+
+TEST(message_length_rejects_negative_content_length) {
+    CHECK_THROWS(message_length("POST / HTTP/1.1\r\nContent-Length: -1\r\n\r\n"), http::error);
+}
+
+TEST(message_length_with_chunked_body) {
+    std::string head = "POST / HTTP/1.1\r\nTransfer-Encoding: gzip, chunked\r\n\r\n",
+                body = "3;ext=1\r\nabc\r\n0\r\nTrailer: x\r\n\r\n";
+
+    for (size_t i = 0; i < body.length(); i++)
+        CHECK(message_length(head + body.substr(0, i)) == 0);
+
+    CHECK(message_length(head + body) == head.length() + body.length());
+    CHECK(message_length(head + body + "GET / HTTP/1.1\r\n\r\n") == head.length() + body.length());
+}
+
+TEST(message_length_prefers_transfer_encoding) {
+    std::string head = "POST / HTTP/1.1\r\nContent-Length: 100\r\nTransfer-Encoding: chunked\r\n\r\n",
+                body = "0\r\n\r\n";
+
+    CHECK(message_length(head + body) == head.length() + body.length());
+
+    // Not chunked unless it's the final coding
+    std::string identity = "POST / HTTP/1.1\r\nContent-Length: 2\r\nTransfer-Encoding: chunked, gzip\r\n\r\nab";
+
+    CHECK(message_length(identity) == identity.length());
+}
+
+// Decode text in pieces of size, and return the data
+static std::string decode_chunked(chunk_decoder& decoder, const std::string_view text, const size_t size) {
+    std::string result;
+
+    for (size_t start = 0; start < text.length(); start += size)
+        decoder.decode(text.substr(start, size), [&result](const std::string_view value) {
+            result += value;
+        });
+
+    return result;
+}
+
+TEST(chunk_decoder_decodes_in_any_pieces) {
+    std::string text = "4\r\nWiki\r\n5;name=\"value\"\r\npedia\r\nE\r\n in\r\n\r\nchunks.\r\n0\r\nExpires: never\r\n\r\n";
+
+    for (size_t size = 1; size <= text.length(); size++) {
+        chunk_decoder decoder;
+
+        CHECK(decode_chunked(decoder, text, size) == "Wikipedia in\r\n\r\nchunks.");
+        CHECK(decoder.done());
+    }
+}
+
+TEST(chunk_decoder_stops_after_the_last_chunk) {
+    chunk_decoder decoder;
+    std::string   data;
+    size_t        length = decoder.decode("a\r\n0123456789\r\n0\r\n\r\nGET / HTTP/1.1\r\n\r\n", [&data](const std::string_view value) {
+        data += value;
+    });
+
+    CHECK(decoder.done());
+    CHECK(length == 20);
+    CHECK(data == "0123456789");
+}
+
+TEST(chunk_decoder_awaits_the_trailer_section) {
+    chunk_decoder decoder;
+
+    decoder.decode("0\r\nTrailer: x\r\n", [](const std::string_view) { });
+
+    CHECK(!decoder.done());
+
+    decoder.decode("\r\n", [](const std::string_view) { });
+
+    CHECK(decoder.done());
+}
+
+TEST(chunk_decoder_rejects_malformed_chunks) {
+    auto decode = [](const std::string_view text) {
+        chunk_decoder decoder;
+
+        return decoder.decode(text, [](const std::string_view) { });
+    };
+
+    // No size
+    CHECK_THROWS(decode(";ext\r\n"), http::error);
+
+    // Data longer than its size
+    CHECK_THROWS(decode("2\r\nabc\r\n"), http::error);
+
+    // Size overflows
+    CHECK_THROWS(decode(std::string(sizeof(size_t) * 2 + 1, 'f') + "\r\n"), http::error);
+
+    CHECK(decode("FF\r\n") == 4);
+}
+
+TEST(message_length_rejects_conflicting_content_lengths) {
+    CHECK_THROWS(message_length("POST / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\nab"), http::error);
+    CHECK_THROWS(message_length("POST / HTTP/1.1\r\nContent-Length: 1, 2\r\n\r\nab"), http::error);
+
+    std::string repeated = "POST / HTTP/1.1\r\nContent-Length: 2\r\nContent-Length: 2\r\n\r\nab";
+
+    CHECK(message_length(repeated) == repeated.length());
+}
+
+TEST(message_framer_frames_messages_arriving_in_pieces) {
+    std::string         first = "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n",
+                        second = "POST / HTTP/1.1\nContent-Length: 3\n\nabc",
+                        stream = first + second;
+    message_framer      framer;
+    std::vector<size_t> lengths;
+    size_t              start = 0;
+
+    // Read a byte at a time, taking messages as they complete
+    for (size_t end = 1; end <= stream.length(); end++) {
+        size_t length = framer.length(std::string_view(stream).substr(start, end - start));
+
+        if (length) {
+            lengths.push_back(length);
+
+            start += length;
+        }
+    }
+
+    CHECK(lengths == std::vector<size_t>({ first.length(), second.length() }));
+}
+
+TEST(message_framer_decodes_each_byte_once) {
+    std::string    head = "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n",
+                   buffer = head + "5\r\nhello\r\n";
+    message_framer framer;
+
+    CHECK(framer.length(buffer) == 0);
+
+    // What was decoded isn't read again, so a change to it goes unnoticed
+    buffer.replace(head.length(), 3, "xyz");
+    buffer += "0\r\n\r\n";
+
+    CHECK(framer.length(buffer) == buffer.length());
+}
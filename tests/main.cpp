@@ -0,0 +1,73 @@
+//
+//  main.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+//  Unit tests, built apart from the server: every source under http-json/src but its main.cpp, and these. From the
+//  repository root,
+//
+//      c++ -std=gnu++20 $(find http-json/src -type d | sed 's/^/-I/') $(find http-json/src -name '*.cpp' ! -path http-json/src/main.cpp) tests/*.cpp -lz -o run_tests
+//
+//  Exits nonzero if any check fails
+//
+
+#include "test.h"
+#include <exception>
+#include <iostream>
+
+namespace test {
+    // Non-Member Fields
+
+    size_t _failures = 0;
+
+    // Non-Member Functions
+
+    void fail(const char* file, const int line, const std::string text) {
+        std::cerr << file << ":" << line << ": check failed: " << text << std::endl;
+
+        _failures++;
+    }
+
+    size_t failures() {
+        return _failures;
+    }
+
+    std::vector<test_case>& tests() {
+        // Constructed on first use; registrars run in any order
+        static std::vector<test_case> result;
+
+        return result;
+    }
+
+    // Constructors
+
+    registrar::registrar(const std::string name, const std::function<void()> function) {
+        tests().push_back({ function, name });
+    }
+}
+
+int main() {
+    size_t failed = 0;
+
+    for (const test::test_case& test_case: test::tests()) {
+        size_t failures = test::failures();
+
+        try {
+            test_case.function();
+        } catch (std::exception& e) {
+            test::fail(test_case.name.c_str(), 0, std::string("uncaught exception: ") + e.what());
+        }
+
+        bool passed = failures == test::failures();
+
+        std::cout << (passed ? "ok      " : "FAILED  ") << test_case.name << std::endl;
+
+        if (!passed)
+            failed++;
+    }
+
+    std::cout << test::tests().size() - failed << " passed, " << failed << " failed" << std::endl;
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,142 @@
+//
+//  router_test.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "router.h"
+#include "test.h"
+
+using namespace http;
+
+// Handler returning name, to tell matches apart
+static router::handler named(const std::string name) {
+    std::shared_ptr<const std::string> text = std::make_shared<const std::string>(name);
+
+    return [text](const request&, const router::params&) {
+        return text;
+    };
+}
+
+// Return the name of the handler found for method and path, or an empty string
+static std::string found(const router& router, const method_code method, const std::string_view path) {
+    router::match match = router.find(method, path);
+
+    return match.handler ? * (* match.handler)(request("GET / HTTP/1.1\r\n\r\n"), match.params) : "";
+}
+
+TEST(router_matches_static_paths) {
+    router router;
+
+    router.add(GET, "/api/users", named("users"));
+    router.add(GET, "/api/uploads", named("uploads"));
+    router.add(GET, "/api", named("api"));
+
+    CHECK(found(router, GET, "/api/users") == "users");
+    CHECK(found(router, GET, "/api/uploads") == "uploads");
+    CHECK(found(router, GET, "/api") == "api");
+    CHECK(found(router, GET, "/api/") == "");
+    CHECK(found(router, GET, "/api/u") == "");
+    CHECK(found(router, GET, "/api/users/1") == "");
+}
+
+TEST(router_tables_handlers_per_method) {
+    router router;
+
+    router.add(GET, "/api/users", named("get"));
+    router.add(POST, "/api/users", named("post"));
+
+    CHECK(found(router, GET, "/api/users") == "get");
+    CHECK(found(router, POST, "/api/users") == "post");
+    CHECK(found(router, DELETE, "/api/users") == "");
+    CHECK(found(router, UNKNOWN_METHOD, "/api/users") == "");
+}
+
+TEST(router_prefers_static_text_to_parameters) {
+    router router;
+
+    router.add(GET, "/api/users/:id", named("user"));
+    router.add(GET, "/api/users/me", named("me"));
+
+    CHECK(found(router, GET, "/api/users/me") == "me");
+    CHECK(found(router, GET, "/api/users/mel") == "user");
+    CHECK(found(router, GET, "/api/users/42") == "user");
+
+    // Parameters are non-empty
+    CHECK(found(router, GET, "/api/users/") == "");
+}
+
+TEST(router_backtracks_to_parameters) {
+    router router;
+
+    router.add(GET, "/api/users/me/settings", named("settings"));
+    router.add(GET, "/api/users/:id/posts", named("posts"));
+
+    // Static text matches "me", but nothing under it matches the rest
+    router::match match = router.find(GET, "/api/users/me/posts");
+
+    CHECK(match.handler != NULL);
+    CHECK(match.params.size() == 1);
+    CHECK(match.params["id"] == "me");
+
+    CHECK(found(router, GET, "/api/users/me/settings") == "settings");
+    CHECK(found(router, GET, "/api/users/you/settings") == "");
+}
+
+TEST(router_captures_parameters) {
+    router router;
+
+    router.add(GET, "/api/users/:user/posts/:post", named("post"));
+
+    router::match match = router.find(GET, "/api/users/7/posts/abc");
+
+    CHECK(match.handler != NULL);
+    CHECK(match.params.size() == 2);
+    CHECK(match.params["user"] == "7");
+    CHECK(match.params["post"] == "abc");
+    CHECK(match.params["missing"] == "");
+
+    // Discarded as a failed branch backtracks
+    match = router.find(GET, "/api/users/7/comments/abc");
+
+    CHECK(match.handler == NULL);
+    CHECK(!match.params.size());
+}
+
+TEST(router_rejects_malformed_paths) {
+    router router;
+
+    router.add(GET, "/api/:id", named("id"));
+
+    CHECK_THROWS(router.add(GET, "api", named("relative")), router::error);
+    CHECK_THROWS(router.add(GET, "/api/:/x", named("unnamed")), router::error);
+    CHECK_THROWS(router.add(GET, "/api/:name", named("conflicting")), router::error);
+    CHECK_THROWS(router.add(UNKNOWN_METHOD, "/api", named("unknown")), router::error);
+
+    std::string path;
+
+    for (size_t i = 0; i <= router::params::capacity(); i++)
+        path += "/:p" + std::to_string(i);
+
+    CHECK_THROWS(router.add(GET, path, named("many")), router::error);
+}
+
+TEST(router_replaces_handlers) {
+    router router;
+
+    router.add(GET, "/api", named("first"));
+    router.add(GET, "/api", [](const request&, const router::params&) -> mysocket::task<std::shared_ptr<const std::string>> {
+        co_return std::make_shared<const std::string>("coroutine");
+    });
+
+    router::match match = router.find(GET, "/api");
+
+    CHECK(match.coroutine != NULL);
+    CHECK(match.handler == NULL);
+
+    router.add(GET, "/api", named("second"));
+
+    CHECK(found(router, GET, "/api") == "second");
+    CHECK(router.find(GET, "/api").coroutine == NULL);
+}
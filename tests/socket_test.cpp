@@ -0,0 +1,118 @@
+//
+//  socket_test.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "socket.h"
+#include "test.h"
+#include <unistd.h>
+
+using namespace mysocket;
+
+// Serve one reply of more than IOV_MAX segments, each sent as queued, and check that it arrives intact
+static void check_many_segments(const bool io_uring) {
+    const size_t                      count = IOV_MAX * 3 + 7;
+    std::shared_ptr<std::string>      text = std::make_shared<std::string>();
+    std::vector<size_t>               offsets;
+
+    // Large enough that sends fall short of it
+    for (size_t i = 0; i < count; i++) {
+        offsets.push_back(text->length());
+
+        * text += "segment " + std::to_string(i) + std::string(1000, '.') + "\n";
+    }
+
+    offsets.push_back(text->length());
+
+    struct tcp_server::options options;
+
+    options.io_uring = io_uring;
+    options.loops = 1;
+
+    std::string path = "@http-json-test-" + std::to_string(getpid()) + (io_uring ? "-uring" : "-epoll");
+    tcp_server* server = new tcp_server(path, [text, offsets](tcp_server::connection* connection) {
+        connection->consume(connection->buffer().length());
+
+        for (size_t i = 0; i + 1 < offsets.size(); i++)
+            connection->queue(std::string_view(* text).substr(offsets[i], offsets[i + 1] - offsets[i]), text);
+
+        connection->flush();
+        connection->close();
+    }, options);
+
+    tcp_client* client = new tcp_client(path);
+    std::string received;
+
+    client->send("go");
+
+    try {
+        while (client->recv(received, std::chrono::milliseconds(5000)))
+            ;
+    } catch (mysocket::error& e) {
+        test::fail(__FILE__, __LINE__, e.what());
+    }
+
+    CHECK(received.length() == text->length());
+    CHECK(received == * text);
+
+    client->close();
+    server->close();
+}
+
+// Send more than the server holds to a handler that never consumes, and check that the overflow reply arrives
+static void check_overflow(const bool io_uring) {
+    struct tcp_server::options options;
+
+    options.buffer_capacity = 4096;
+    options.io_uring = io_uring;
+    options.loops = 1;
+    options.overflow = [](tcp_server::connection* connection) {
+        connection->queue(std::make_shared<const std::string>("too large"));
+    };
+
+    std::string path = "@http-json-test-" + std::to_string(getpid()) + (io_uring ? "-uring" : "-epoll") + "-overflow";
+    tcp_server* server = new tcp_server(path, [](tcp_server::connection*) {
+        // Waits for a request that never fits
+    }, options);
+
+    tcp_client* client = new tcp_client(path);
+    std::string received;
+
+    client->send(std::string(options.buffer_capacity * 2, '.'));
+
+    try {
+        while (client->recv(received, std::chrono::milliseconds(5000)))
+            ;
+    } catch (mysocket::error& e) {
+        // Closing with the rest unread resets the connection, after the reply
+        if (e.errnum() != ECONNRESET)
+            test::fail(__FILE__, __LINE__, e.what());
+    }
+
+    CHECK(received == "too large");
+
+    client->close();
+    server->close();
+}
+
+TEST(tcp_server_replies_to_overflow) {
+    check_overflow(false);
+}
+
+#ifdef __linux__
+TEST(tcp_server_replies_to_overflow_through_io_uring) {
+    check_overflow(true);
+}
+#endif
+
+TEST(tcp_server_sends_more_than_iov_max_segments) {
+    check_many_segments(false);
+}
+
+#ifdef __linux__
+TEST(tcp_server_sends_more_than_iov_max_segments_through_io_uring) {
+    check_many_segments(true);
+}
+#endif
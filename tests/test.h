@@ -0,0 +1,75 @@
+//
+//  test.h
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#ifndef test_h
+#define test_h
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace test {
+    // Typedef
+
+    struct test_case {
+        // Member Fields
+
+        std::function<void()> function;
+        std::string           name;
+    };
+
+    /**
+     * Registers a test at static initialization
+     */
+    struct registrar {
+        // Constructors
+
+        registrar(const std::string name, const std::function<void()> function);
+    };
+
+    // Non-Member Functions
+
+    /**
+     * Record a failed check in the running test
+     */
+    void                    fail(const char* file, const int line, const std::string text);
+
+    /**
+     * Return the number of checks failed so far
+     */
+    size_t                  failures();
+
+    std::vector<test_case>& tests();
+}
+
+/**
+ * Define and register a test
+ */
+#define TEST(name) \
+    static void name(); \
+    static test::registrar name##_registrar(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    ((condition) ? (void) 0 : test::fail(__FILE__, __LINE__, #condition))
+
+/**
+ * Check that expression throws exception, or a type derived from it
+ */
+#define CHECK_THROWS(expression, exception) \
+    do { \
+        bool _thrown = false; \
+        try { \
+            (void) (expression); \
+        } catch (exception&) { \
+            _thrown = true; \
+        } \
+        if (!_thrown) \
+            test::fail(__FILE__, __LINE__, #expression " doesn't throw " #exception); \
+    } while (0)
+
+#endif /* test_h */
@@ -0,0 +1,113 @@
+//
+//  timer_wheel_test.cpp
+//  http-json
+//
+//  Created by Corey Ferguson on 10/19/26.
+//
+
+#include "test.h"
+#include "timer_wheel.h"
+#include <thread>
+
+using namespace mysocket;
+
+// Run wheel until it's empty or deadline passes, sleeping as long as it says
+static void run_until_empty(timer_wheel& wheel, const std::chrono::milliseconds deadline) {
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + deadline;
+
+    while (wheel.size() && std::chrono::steady_clock::now() < end) {
+        std::this_thread::sleep_for(std::min(wheel.next(), std::chrono::milliseconds(50)));
+
+        wheel.run();
+    }
+}
+
+TEST(timer_wheel_cascades_in_order) {
+    timer_wheel                            wheel;
+    std::chrono::steady_clock::time_point  start = std::chrono::steady_clock::now();
+
+    // Beyond level 0's 256 ticks, in two of level 1's slots, plus one that stays in level 0
+    const int                              delays[] = { 520, 300, 100, 260 };
+    std::vector<std::chrono::milliseconds> elapsed;
+    std::vector<int>                       fired;
+    timer_wheel::timer                     timers[4];
+
+    for (size_t i = 0; i < std::size(timers); i++) {
+        timers[i].function = [&, i]() {
+            fired.push_back(delays[i]);
+            elapsed.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+        };
+
+        wheel.arm(timers[i], std::chrono::milliseconds(delays[i]));
+    }
+
+    CHECK(wheel.size() == 4);
+    CHECK(wheel.next() <= std::chrono::milliseconds(100));
+
+    run_until_empty(wheel, std::chrono::milliseconds(2000));
+
+    CHECK(fired == std::vector<int>({ 100, 260, 300, 520 }));
+
+    for (size_t i = 0; i < std::min(fired.size(), elapsed.size()); i++)
+        // Ticks are whole milliseconds; never early by more than one
+        CHECK(elapsed[i] >= std::chrono::milliseconds(fired[i] - 1));
+
+    for (const timer_wheel::timer& timer: timers)
+        CHECK(!timer.armed());
+
+    CHECK(wheel.next() == std::chrono::milliseconds::max());
+}
+
+TEST(timer_wheel_rearms_and_cancels) {
+    timer_wheel        wheel;
+    timer_wheel::timer repeating,
+                       canceled;
+    int                count = 0;
+
+    // Re-armed from its own function, past level 0 each time but the first
+    repeating.function = [&]() {
+        if (++count < 3)
+            wheel.arm(repeating, std::chrono::milliseconds(count * 150));
+    };
+    canceled.function = [&]() {
+        count = 100;
+    };
+
+    wheel.arm(repeating, std::chrono::milliseconds(10));
+    wheel.arm(canceled, std::chrono::milliseconds(280));
+
+    // Replaces the earlier arming
+    wheel.arm(canceled, std::chrono::milliseconds(290));
+
+    CHECK(wheel.size() == 2);
+
+    wheel.cancel(canceled);
+    wheel.cancel(canceled);
+
+    CHECK(wheel.size() == 1);
+    CHECK(!canceled.armed());
+
+    run_until_empty(wheel, std::chrono::milliseconds(2000));
+
+    CHECK(count == 3);
+    CHECK(!wheel.size());
+}
+
+TEST(timer_wheel_holds_distant_timers) {
+    timer_wheel        wheel;
+    timer_wheel::timer timer;
+
+    // Beyond the last level
+    wheel.arm(timer, std::chrono::milliseconds::max());
+
+    CHECK(timer.armed());
+    CHECK(wheel.next() > std::chrono::hours(24));
+
+    wheel.run();
+
+    CHECK(timer.armed());
+
+    wheel.cancel(timer);
+
+    CHECK(!wheel.size());
+}